@@ -120,12 +120,49 @@ debounce_set_state(struct fallback_dispatch *fallback,
 	fallback->debounce.state = new_state;
 }
 
+static void
+debounce_timeout(uint64_t now, void *data);
+
+static void
+debounce_timeout_short(uint64_t now, void *data);
+
+static void
+debounce_init_timers(struct fallback_dispatch *fallback)
+{
+	struct evdev_device *device = fallback->device;
+	char timer_name[64];
+
+	if (libinput_timer_is_initialized(&fallback->debounce.timer))
+		return;
+
+	snprintf(timer_name,
+		 sizeof(timer_name),
+		 "%s debounce short",
+		 evdev_device_get_sysname(device));
+	libinput_timer_init(&fallback->debounce.timer_short,
+			    evdev_libinput_context(device),
+			    timer_name,
+			    debounce_timeout_short,
+			    device);
+
+	snprintf(timer_name,
+		 sizeof(timer_name),
+		 "%s debounce",
+		 evdev_device_get_sysname(device));
+	libinput_timer_init(&fallback->debounce.timer,
+			    evdev_libinput_context(device),
+			    timer_name,
+			    debounce_timeout,
+			    device);
+}
+
 static inline void
 debounce_set_timer(struct fallback_dispatch *fallback,
 		   uint64_t time)
 {
 	const int DEBOUNCE_TIMEOUT_BOUNCE = ms2us(25);
 
+	debounce_init_timers(fallback);
 	libinput_timer_set(&fallback->debounce.timer,
 			   time + DEBOUNCE_TIMEOUT_BOUNCE);
 }
@@ -136,6 +173,7 @@ debounce_set_timer_short(struct fallback_dispatch *fallback,
 {
 	const int DEBOUNCE_TIMEOUT_SPURIOUS = ms2us(12);
 
+	debounce_init_timers(fallback);
 	libinput_timer_set(&fallback->debounce.timer_short,
 			   time + DEBOUNCE_TIMEOUT_SPURIOUS);
 }
@@ -468,6 +506,14 @@ debounce_handle_event(struct fallback_dispatch *fallback,
 			debounce_state_to_str(current),
 			debounce_event_to_str(event),
 			debounce_state_to_str(fallback->debounce.state));
+	trace_transition(evdev_libinput_context(fallback->device),
+			 &fallback->device->base,
+			 TRACE_DEBOUNCE,
+			 -1,
+			 debounce_state_to_str(current),
+			 debounce_event_to_str(event),
+			 debounce_state_to_str(fallback->debounce.state),
+			 time);
 }
 
 void
@@ -563,7 +609,6 @@ void
 fallback_init_debounce(struct fallback_dispatch *dispatch)
 {
 	struct evdev_device *device = dispatch->device;
-	char timer_name[64];
 
 	if (device->model_flags &
 	    (EVDEV_MODEL_MS_NANO_TRANSCEIVER|EVDEV_MODEL_LOGITECH_K400)) {
@@ -571,25 +616,7 @@ fallback_init_debounce(struct fallback_dispatch *dispatch)
 		return;
 	}
 
+	/* Timers are initialized when the first button press arms them,
+	 * see debounce_init_timers() */
 	dispatch->debounce.state = DEBOUNCE_STATE_IS_UP;
-
-	snprintf(timer_name,
-		 sizeof(timer_name),
-		 "%s debounce short",
-		 evdev_device_get_sysname(device));
-	libinput_timer_init(&dispatch->debounce.timer_short,
-			    evdev_libinput_context(device),
-			    timer_name,
-			    debounce_timeout_short,
-			    device);
-
-	snprintf(timer_name,
-		 sizeof(timer_name),
-		 "%s debounce",
-		 evdev_device_get_sysname(device));
-	libinput_timer_init(&dispatch->debounce.timer,
-			    evdev_libinput_context(device),
-			    timer_name,
-			    debounce_timeout,
-			    device);
 }
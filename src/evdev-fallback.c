@@ -647,6 +647,7 @@ fallback_lid_toggle_keyboard_listener(struct fallback_dispatch *dispatch,
 		libinput_device_add_event_listener(
 					&kbd->device->base,
 					&kbd->listener,
+					EVENT_TYPE_MASK(LIBINPUT_EVENT_KEYBOARD_KEY),
 					fallback_lid_keyboard_event,
 					dispatch);
 	} else {
@@ -877,17 +878,12 @@ fallback_handle_state(struct fallback_dispatch *dispatch,
 	dispatch->pending_event = EVDEV_NONE;
 }
 
-static void
-fallback_interface_process(struct evdev_dispatch *evdev_dispatch,
-			   struct evdev_device *device,
-			   struct input_event *event,
-			   uint64_t time)
+static inline void
+fallback_process_event(struct fallback_dispatch *dispatch,
+		       struct evdev_device *device,
+		       struct input_event *event,
+		       uint64_t time)
 {
-	struct fallback_dispatch *dispatch = fallback_dispatch(evdev_dispatch);
-
-	if (dispatch->ignore_events)
-		return;
-
 	switch (event->type) {
 	case EV_REL:
 		fallback_process_relative(dispatch, device, event, time);
@@ -907,6 +903,37 @@ fallback_interface_process(struct evdev_dispatch *evdev_dispatch,
 	}
 }
 
+static void
+fallback_interface_process(struct evdev_dispatch *evdev_dispatch,
+			   struct evdev_device *device,
+			   struct input_event *event,
+			   uint64_t time)
+{
+	struct fallback_dispatch *dispatch = fallback_dispatch(evdev_dispatch);
+
+	if (dispatch->ignore_events)
+		return;
+
+	fallback_process_event(dispatch, device, event, time);
+}
+
+static void
+fallback_interface_process_frame(struct evdev_dispatch *evdev_dispatch,
+				 struct evdev_device *device,
+				 struct input_event *events,
+				 size_t nevents,
+				 uint64_t time)
+{
+	struct fallback_dispatch *dispatch = fallback_dispatch(evdev_dispatch);
+	size_t i;
+
+	if (dispatch->ignore_events)
+		return;
+
+	for (i = 0; i < nevents; i++)
+		fallback_process_event(dispatch, device, &events[i], time);
+}
+
 static void
 release_touches(struct fallback_dispatch *dispatch,
 		struct evdev_device *device,
@@ -1205,6 +1232,7 @@ fallback_keyboard_pair_tablet_mode(struct evdev_device *keyboard,
 
 	libinput_device_add_event_listener(&tablet_mode_switch->base,
 				&dispatch->tablet_mode.other.listener,
+				EVENT_TYPE_MASK(LIBINPUT_EVENT_SWITCH_TOGGLE),
 				fallback_tablet_mode_switch_event,
 				dispatch);
 	dispatch->tablet_mode.other.sw_device = tablet_mode_switch;
@@ -1254,6 +1282,7 @@ fallback_interface_device_removed(struct evdev_device *device,
 
 struct evdev_dispatch_interface fallback_interface = {
 	.process = fallback_interface_process,
+	.process_frame = fallback_interface_process_frame,
 	.suspend = fallback_interface_suspend,
 	.remove = fallback_interface_remove,
 	.destroy = fallback_interface_destroy,
@@ -143,9 +143,32 @@ is_inside_top_middle_area(const struct tp_dispatch *tp,
 	       t->point.x <= tp->buttons.top_area.rightbutton_left_edge;
 }
 
+static void
+tp_button_handle_timeout(uint64_t now, void *data);
+
+static void
+tp_button_init_timer(struct tp_dispatch *tp, struct tp_touch *t)
+{
+	char timer_name[64];
+
+	if (libinput_timer_is_initialized(&t->button.timer))
+		return;
+
+	snprintf(timer_name,
+		 sizeof(timer_name),
+		 "%s (%d) button",
+		 evdev_device_get_sysname(tp->device),
+		 t->index + 1);
+	libinput_timer_init(&t->button.timer,
+			    tp_libinput_context(tp),
+			    timer_name,
+			    tp_button_handle_timeout, t);
+}
+
 static void
 tp_button_set_enter_timer(struct tp_dispatch *tp, struct tp_touch *t)
 {
+	tp_button_init_timer(tp, t);
 	libinput_timer_set(&t->button.timer,
 			   t->time + DEFAULT_BUTTON_ENTER_TIMEOUT);
 }
@@ -153,6 +176,7 @@ tp_button_set_enter_timer(struct tp_dispatch *tp, struct tp_touch *t)
 static void
 tp_button_set_leave_timer(struct tp_dispatch *tp, struct tp_touch *t)
 {
+	tp_button_init_timer(tp, t);
 	libinput_timer_set(&t->button.timer,
 			   t->time + DEFAULT_BUTTON_LEAVE_TIMEOUT);
 }
@@ -446,13 +470,22 @@ tp_button_handle_event(struct tp_dispatch *tp,
 		break;
 	}
 
-	if (current != t->button.state)
+	if (current != t->button.state) {
 		evdev_log_debug(tp->device,
 				"button state: touch %d from %s, event %s to %s\n",
 				t->index,
 				button_state_to_str(current),
 				button_event_to_str(event),
 				button_state_to_str(t->button.state));
+		trace_transition(tp_libinput_context(tp),
+				 &tp->device->base,
+				 TRACE_BUTTON,
+				 (int)t->index,
+				 button_state_to_str(current),
+				 button_event_to_str(event),
+				 button_state_to_str(t->button.state),
+				 time);
+	}
 }
 
 void
@@ -836,7 +869,6 @@ tp_init_buttons(struct tp_dispatch *tp,
 {
 	struct tp_touch *t;
 	const struct input_absinfo *absinfo_x, *absinfo_y;
-	int i;
 
 	tp->buttons.is_clickpad = libevdev_has_property(device->evdev,
 							INPUT_PROP_BUTTONPAD);
@@ -875,22 +907,10 @@ tp_init_buttons(struct tp_dispatch *tp,
 
 	tp_init_middlebutton_emulation(tp, device);
 
-	i = 0;
-	tp_for_each_touch(tp, t) {
-		char timer_name[64];
-		i++;
-
-		snprintf(timer_name,
-			 sizeof(timer_name),
-			 "%s (%d) button",
-			 evdev_device_get_sysname(device),
-			 i);
+	/* The per-touch timers are initialized on first use, most
+	 * touches never get near a button area */
+	tp_for_each_touch(tp, t)
 		t->button.state = BUTTON_STATE_NONE;
-		libinput_timer_init(&t->button.timer,
-				    tp_libinput_context(tp),
-				    timer_name,
-				    tp_button_handle_timeout, t);
-	}
 }
 
 void
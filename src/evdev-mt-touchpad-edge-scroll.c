@@ -89,6 +89,9 @@ tp_touch_get_edge(const struct tp_dispatch *tp, const struct tp_touch *t)
 	return edge;
 }
 
+static void
+tp_edge_scroll_handle_timeout(uint64_t now, void *data);
+
 static inline void
 tp_edge_scroll_set_timer(struct tp_dispatch *tp,
 			 struct tp_touch *t)
@@ -98,10 +101,24 @@ tp_edge_scroll_set_timer(struct tp_dispatch *tp,
 	 * edge scrolling. A finger resting on the button areas is
 	 * likely there to trigger a button event.
 	 */
+	char timer_name[64];
+
 	if (tp->buttons.click_method ==
 	    LIBINPUT_CONFIG_CLICK_METHOD_BUTTON_AREAS)
 		return;
 
+	if (!libinput_timer_is_initialized(&t->scroll.timer)) {
+		snprintf(timer_name,
+			 sizeof(timer_name),
+			 "%s (%d) edgescroll",
+			 evdev_device_get_sysname(tp->device),
+			 t->index);
+		libinput_timer_init(&t->scroll.timer,
+				    tp_libinput_context(tp),
+				    timer_name,
+				    tp_edge_scroll_handle_timeout, t);
+	}
+
 	libinput_timer_set(&t->scroll.timer,
 			   t->time + DEFAULT_SCROLL_LOCK_TIMEOUT);
 }
@@ -266,6 +283,14 @@ tp_edge_scroll_handle_event(struct tp_dispatch *tp,
 			edge_state_to_str(current),
 			edge_event_to_str(event),
 			edge_state_to_str(t->scroll.edge_state));
+	trace_transition(tp_libinput_context(tp),
+			 &tp->device->base,
+			 TRACE_EDGE_SCROLL,
+			 (int)t->index,
+			 edge_state_to_str(current),
+			 edge_event_to_str(event),
+			 edge_state_to_str(t->scroll.edge_state),
+			 libinput_now(tp_libinput_context(tp)));
 }
 
 static void
@@ -284,7 +309,6 @@ tp_edge_scroll_init(struct tp_dispatch *tp, struct evdev_device *device)
 	bool want_horiz_scroll = true;
 	struct device_coords edges;
 	struct phys_coords mm = { 0.0, 0.0 };
-	int i;
 
 	evdev_device_get_size(device, &width, &height);
 	/* Touchpads smaller than 40mm are not tall enough to have a
@@ -307,21 +331,10 @@ tp_edge_scroll_init(struct tp_dispatch *tp, struct evdev_device *device)
 	else
 		tp->scroll.bottom_edge = INT_MAX;
 
-	i = 0;
-	tp_for_each_touch(tp, t) {
-		char timer_name[64];
-
-		snprintf(timer_name,
-			 sizeof(timer_name),
-			 "%s (%d) edgescroll",
-			 evdev_device_get_sysname(device),
-			 i);
+	/* timers are initialized on first use in
+	 * tp_edge_scroll_set_timer() */
+	tp_for_each_touch(tp, t)
 		t->scroll.direction = -1;
-		libinput_timer_init(&t->scroll.timer,
-				    tp_libinput_context(tp),
-				    timer_name,
-				    tp_edge_scroll_handle_timeout, t);
-	}
 }
 
 void
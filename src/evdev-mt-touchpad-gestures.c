@@ -505,6 +505,15 @@ tp_gesture_post_gesture(struct tp_dispatch *tp, uint64_t time)
 			"gesture state: %s → %s\n",
 			gesture_state_to_str(oldstate),
 			gesture_state_to_str(tp->gesture.state));
+	if (oldstate != tp->gesture.state)
+		trace_transition(tp_libinput_context(tp),
+				 &tp->device->base,
+				 TRACE_GESTURE,
+				 -1,
+				 gesture_state_to_str(oldstate),
+				 NULL,
+				 gesture_state_to_str(tp->gesture.state),
+				 time);
 }
 
 void
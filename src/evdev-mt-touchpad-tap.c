@@ -975,6 +975,14 @@ tp_tap_handle_event(struct tp_dispatch *tp,
 		  tap_state_to_str(current),
 		  tap_event_to_str(event),
 		  tap_state_to_str(tp->tap.state));
+	trace_transition(tp_libinput_context(tp),
+			 &tp->device->base,
+			 TRACE_TAP,
+			 t ? (int)t->index : -1,
+			 tap_state_to_str(current),
+			 tap_event_to_str(event),
+			 tap_state_to_str(tp->tap.state),
+			 time);
 }
 
 static bool
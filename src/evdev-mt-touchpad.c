@@ -1745,6 +1745,36 @@ tp_interface_process(struct evdev_dispatch *dispatch,
 	}
 }
 
+static void
+tp_interface_process_frame(struct evdev_dispatch *dispatch,
+			   struct evdev_device *device,
+			   struct input_event *events,
+			   size_t nevents,
+			   uint64_t time)
+{
+	struct tp_dispatch *tp = tp_dispatch(dispatch);
+	struct input_event *e;
+	size_t i;
+
+	/* The frame ends in the SYN_REPORT, everything before it only
+	 * updates the touch state. The state is handled once for the
+	 * whole frame below. */
+	for (i = 0; i < nevents - 1; i++) {
+		e = &events[i];
+
+		if (e->type == EV_KEY)
+			tp_process_key(tp, e, time);
+		else if (e->type != EV_ABS)
+			continue;
+		else if (tp->has_mt)
+			tp_process_absolute(tp, e, time);
+		else
+			tp_process_absolute_st(tp, e, time);
+	}
+
+	tp_handle_state(tp, time);
+}
+
 static void
 tp_remove_sendevents(struct tp_dispatch *tp)
 {
@@ -2151,6 +2181,7 @@ tp_dwt_pair_keyboard(struct evdev_device *touchpad,
 		found = true;
 		libinput_device_add_event_listener(&keyboard->base,
 						   &kbd->listener,
+						   EVENT_TYPE_MASK(LIBINPUT_EVENT_KEYBOARD_KEY),
 						   tp_keyboard_event, tp);
 		kbd->device = keyboard;
 		evdev_log_debug(touchpad,
@@ -2188,6 +2219,9 @@ tp_pair_trackpoint(struct evdev_device *touchpad,
 		if (tp->palm.monitor_trackpoint)
 			libinput_device_add_event_listener(&trackpoint->base,
 						&tp->palm.trackpoint_listener,
+						EVENT_TYPE_MASK(LIBINPUT_EVENT_POINTER_MOTION) |
+						EVENT_TYPE_MASK(LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE) |
+						EVENT_TYPE_MASK(LIBINPUT_EVENT_POINTER_AXIS),
 						tp_trackpoint_event, tp);
 	}
 }
@@ -2242,6 +2276,7 @@ tp_pair_lid_switch(struct evdev_device *touchpad,
 
 		libinput_device_add_event_listener(&lid_switch->base,
 						   &tp->lid_switch.listener,
+						   EVENT_TYPE_MASK(LIBINPUT_EVENT_SWITCH_TOGGLE),
 						   tp_switch_event, tp);
 		tp->lid_switch.lid_switch = lid_switch;
 	}
@@ -2266,6 +2301,7 @@ tp_pair_tablet_mode_switch(struct evdev_device *touchpad,
 
 	libinput_device_add_event_listener(&tablet_mode_switch->base,
 				&tp->tablet_mode_switch.listener,
+				EVENT_TYPE_MASK(LIBINPUT_EVENT_SWITCH_TOGGLE),
 				tp_switch_event, tp);
 	tp->tablet_mode_switch.tablet_mode_switch = tablet_mode_switch;
 
@@ -2456,6 +2492,7 @@ tp_interface_toggle_touch(struct evdev_dispatch *dispatch,
 
 static struct evdev_dispatch_interface tp_interface = {
 	.process = tp_interface_process,
+	.process_frame = tp_interface_process_frame,
 	.suspend = tp_interface_suspend,
 	.remove = tp_interface_remove,
 	.destroy = tp_interface_destroy,
@@ -2784,8 +2821,8 @@ tp_is_tpkb_combo_below(struct evdev_device *device)
 	const char *prop;
 	enum tpkbcombo_layout layout = TPKBCOMBO_LAYOUT_UNKNOWN;
 
-	prop = udev_device_get_property_value(device->udev_device,
-					      "LIBINPUT_ATTR_TPKBCOMBO_LAYOUT");
+	prop = evdev_device_get_quirk_attr(device,
+					   EVDEV_QUIRK_ATTR_TPKBCOMBO_LAYOUT);
 	if (!prop)
 		return false;
 
@@ -2857,13 +2894,12 @@ static int
 tp_read_palm_pressure_prop(struct tp_dispatch *tp,
 			   const struct evdev_device *device)
 {
-	struct udev_device *udev_device = device->udev_device;
 	const char *prop;
 	int threshold;
 	const int default_palm_threshold = 130;
 
-	prop = udev_device_get_property_value(udev_device,
-			      "LIBINPUT_ATTR_PALM_PRESSURE_THRESHOLD");
+	prop = evdev_device_get_quirk_attr(device,
+					   EVDEV_QUIRK_ATTR_PALM_PRESSURE_THRESHOLD);
 	if (!prop)
 		return default_palm_threshold;
 
@@ -2896,8 +2932,8 @@ tp_init_palmdetect_size(struct tp_dispatch *tp,
 	const char *prop;
 	int threshold;
 
-	prop = udev_device_get_property_value(device->udev_device,
-					      "LIBINPUT_ATTR_PALM_SIZE_THRESHOLD");
+	prop = evdev_device_get_quirk_attr(device,
+					   EVDEV_QUIRK_ATTR_PALM_SIZE_THRESHOLD);
 	if (!prop)
 		return;
 
@@ -3143,8 +3179,8 @@ tp_init_pressure(struct tp_dispatch *tp,
 	abs = libevdev_get_abs_info(device->evdev, code);
 	assert(abs);
 
-	prop = udev_device_get_property_value(device->udev_device,
-					      "LIBINPUT_ATTR_PRESSURE_RANGE");
+	prop = evdev_device_get_quirk_attr(device,
+					   EVDEV_QUIRK_ATTR_PRESSURE_RANGE);
 	if (prop) {
 		if (!parse_range_property(prop, &hi, &lo)) {
 			evdev_log_bug_client(device,
@@ -3197,8 +3233,8 @@ tp_init_touch_size(struct tp_dispatch *tp,
 		return false;
 	}
 
-	prop = udev_device_get_property_value(device->udev_device,
-					      "LIBINPUT_ATTR_TOUCH_SIZE_RANGE");
+	prop = evdev_device_get_quirk_attr(device,
+					   EVDEV_QUIRK_ATTR_TOUCH_SIZE_RANGE);
 	if (!prop)
 		return false;
 
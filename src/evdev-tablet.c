@@ -1799,6 +1799,19 @@ tablet_process(struct evdev_dispatch *dispatch,
 	}
 }
 
+static void
+tablet_process_frame(struct evdev_dispatch *dispatch,
+		     struct evdev_device *device,
+		     struct input_event *events,
+		     size_t nevents,
+		     uint64_t time)
+{
+	size_t i;
+
+	for (i = 0; i < nevents; i++)
+		tablet_process(dispatch, device, &events[i], time);
+}
+
 static void
 tablet_suspend(struct evdev_dispatch *dispatch,
 	       struct evdev_device *device)
@@ -1904,6 +1917,7 @@ tablet_check_initial_proximity(struct evdev_device *device,
 
 static struct evdev_dispatch_interface tablet_interface = {
 	.process = tablet_process,
+	.process_frame = tablet_process_frame,
 	.suspend = tablet_suspend,
 	.remove = NULL,
 	.destroy = tablet_destroy,
@@ -424,8 +424,8 @@ evdev_tag_keyboard(struct evdev_device *device,
 	}
 
 	/* This should eventually become ID_INPUT_KEYBOARD_INTEGRATION */
-	prop = udev_device_get_property_value(udev_device,
-					      "LIBINPUT_ATTR_KEYBOARD_INTEGRATION");
+	prop = evdev_device_get_quirk_attr(device,
+					   EVDEV_QUIRK_ATTR_KEYBOARD_INTEGRATION);
 	if (prop) {
 		if (streq(prop, "internal")) {
 			evdev_tag_keyboard_internal(device);
@@ -799,8 +799,8 @@ evdev_read_switch_reliability_prop(struct evdev_device *device)
 	const char *prop;
 	enum switch_reliability r;
 
-	prop = udev_device_get_property_value(device->udev_device,
-					      "LIBINPUT_ATTR_LID_SWITCH_RELIABILITY");
+	prop = evdev_device_get_quirk_attr(device,
+					   EVDEV_QUIRK_ATTR_LID_SWITCH_RELIABILITY);
 	if (!parse_switch_reliability_property(prop, &r)) {
 		evdev_log_error(device,
 				"%s: switch reliability set to unknown value '%s'\n",
@@ -898,32 +898,37 @@ evdev_sync_device(struct evdev_device *device)
 	return rc == -EAGAIN ? 0 : rc;
 }
 
-static void
-evdev_device_dispatch(void *data)
+/* Number of events read from the fd with a single read() */
+#define EVDEV_READ_BATCH_SIZE 64
+
+static int
+evdev_device_handle_syn_dropped(struct evdev_device *device,
+				struct input_event *ev)
+{
+	evdev_log_info_ratelimit(device,
+				 &device->syn_drop_limit,
+				 "SYN_DROPPED event - some input events have been lost.\n");
+
+	/* send one more sync event so we handle all
+	   currently pending events before we sync up
+	   to the current state */
+	ev->code = SYN_REPORT;
+	evdev_device_dispatch_one(device, ev);
+
+	return evdev_sync_device(device);
+}
+
+static int
+evdev_device_dispatch_libevdev(struct evdev_device *device)
 {
-	struct evdev_device *device = data;
-	struct libinput *libinput = evdev_libinput_context(device);
 	struct input_event ev;
 	int rc;
 
-	/* If the compositor is repainting, this function is called only once
-	 * per frame and we have to process all the events available on the
-	 * fd, otherwise there will be input lag. */
 	do {
 		rc = libevdev_next_event(device->evdev,
 					 LIBEVDEV_READ_FLAG_NORMAL, &ev);
 		if (rc == LIBEVDEV_READ_STATUS_SYNC) {
-			evdev_log_info_ratelimit(device,
-						 &device->syn_drop_limit,
-						 "SYN_DROPPED event - some input events have been lost.\n");
-
-			/* send one more sync event so we handle all
-			   currently pending events before we sync up
-			   to the current state */
-			ev.code = SYN_REPORT;
-			evdev_device_dispatch_one(device, &ev);
-
-			rc = evdev_sync_device(device);
+			rc = evdev_device_handle_syn_dropped(device, &ev);
 			if (rc == 0)
 				rc = LIBEVDEV_READ_STATUS_SUCCESS;
 		} else if (rc == LIBEVDEV_READ_STATUS_SUCCESS) {
@@ -931,12 +936,251 @@ evdev_device_dispatch(void *data)
 		}
 	} while (rc == LIBEVDEV_READ_STATUS_SUCCESS);
 
+	return rc;
+}
+
+/* Update libevdev's view of the device for an event we read from the fd
+ * ourselves. Returns false for events libevdev would have filtered, e.g.
+ * events for disabled codes or an invalid slot. */
+static inline bool
+evdev_update_libevdev_state(struct evdev_device *device,
+			    const struct input_event *e)
+{
+	switch (e->type) {
+	case EV_SYN:
+		return true;
+	case EV_KEY:
+	case EV_ABS:
+	case EV_SW:
+	case EV_LED:
+		return libevdev_set_event_value(device->evdev,
+						e->type,
+						e->code,
+						e->value) == 0;
+	default:
+		return libevdev_has_event_code(device->evdev,
+					       e->type,
+					       e->code);
+	}
+}
+
+static inline void
+evdev_device_dispatch_events(struct evdev_device *device,
+			     struct input_event *events,
+			     size_t nevents)
+{
+	size_t i;
+
+	for (i = 0; i < nevents; i++)
+		evdev_device_dispatch_one(device, &events[i]);
+}
+
+static inline void
+evdev_device_dispatch_frame(struct evdev_device *device,
+			    struct input_event *events,
+			    size_t nevents)
+{
+	struct evdev_dispatch *dispatch = device->dispatch;
+	uint64_t time;
+
+	if (device->mtdev || !dispatch->interface->process_frame) {
+		evdev_device_dispatch_events(device, events, nevents);
+		return;
+	}
+
+	/* The kernel timestamps all events of a frame identically */
+	time = tv2us(&events[nevents - 1].time);
+
+	libinput_timer_flush(evdev_libinput_context(device), time);
+
+	dispatch->interface->process_frame(dispatch,
+					   device,
+					   events,
+					   nevents,
+					   time);
+}
+
+/* Process the events in ev[nqueued..nevents), the nqueued events before
+ * are an incomplete frame from the previous batch. Returns the number of
+ * events of a trailing incomplete frame, moved to the start of ev. After
+ * a SYN_DROPPED the device is resynced and drained through libevdev
+ * instead, this returns -1 and *rc is the result. */
+static ssize_t
+evdev_device_process_batch(struct evdev_device *device,
+			   struct input_event *ev,
+			   size_t nqueued,
+			   size_t nevents,
+			   int *rc)
+{
+	struct input_event dropped;
+	size_t i, n;
+	size_t frame_start = 0;
+
+	/* Filtered events are dropped by compacting the buffer, n is the
+	 * write index */
+	for (i = nqueued, n = nqueued; i < nevents; i++) {
+		if (libevdev_event_is_code(&ev[i], EV_SYN, SYN_DROPPED)) {
+			evdev_device_dispatch_events(device,
+						     &ev[frame_start],
+						     n - frame_start);
+
+			/* Hand over to libevdev to sync the state, the
+			 * remainder of this batch predates the sync and is
+			 * discarded */
+			libevdev_next_event(device->evdev,
+					    LIBEVDEV_READ_FLAG_FORCE_SYNC,
+					    &dropped);
+			*rc = evdev_device_handle_syn_dropped(device, &ev[i]);
+			if (*rc == 0)
+				*rc = evdev_device_dispatch_libevdev(device);
+			return -1;
+		}
+
+		if (!evdev_update_libevdev_state(device, &ev[i]))
+			continue;
+
+		if (n != i)
+			ev[n] = ev[i];
+		n++;
+
+		if (libevdev_event_is_code(&ev[n - 1], EV_SYN, SYN_REPORT)) {
+			evdev_device_dispatch_frame(device,
+						    &ev[frame_start],
+						    n - frame_start);
+			frame_start = n;
+		}
+	}
+
+	nqueued = n - frame_start;
+	if (nqueued > 0 && frame_start > 0)
+		memmove(ev, &ev[frame_start], nqueued * sizeof(ev[0]));
+
+	return nqueued;
+}
+
+/* Reads and processes everything available on the fd. The ncarried
+ * events are an incomplete frame read elsewhere and are processed
+ * first. */
+static int
+evdev_device_dispatch_batch(struct evdev_device *device,
+			    const struct input_event *carried,
+			    size_t ncarried)
+{
+	struct input_event ev[EVDEV_READ_BATCH_SIZE];
+	size_t space;
+	ssize_t len, nqueued;
+	bool drained;
+	int rc = -EAGAIN;
+
+	assert(ncarried < ARRAY_LENGTH(ev));
+	if (ncarried > 0)
+		memcpy(ev, carried, ncarried * sizeof(ev[0]));
+	nqueued = ncarried;
+
+	do {
+		space = sizeof(ev) - nqueued * sizeof(ev[0]);
+		len = read(device->fd, &ev[nqueued], space);
+		if (len < 0) {
+			rc = -errno;
+			break;
+		}
+		if (len % sizeof(ev[0]) != 0) {
+			rc = -EINVAL;
+			break;
+		}
+
+		/* A short read means the fd is drained, epoll will tell us
+		 * about the next batch */
+		drained = (size_t)len < space;
+		nqueued = evdev_device_process_batch(device,
+						     ev,
+						     nqueued,
+						     nqueued + len / sizeof(ev[0]),
+						     &rc);
+		if (nqueued < 0)
+			return rc;
+
+		/* Keep an incomplete frame for the next read. A frame that
+		 * doesn't fit into the buffer is processed event by
+		 * event. */
+		if (nqueued == ARRAY_LENGTH(ev)) {
+			evdev_device_dispatch_events(device, ev, nqueued);
+			nqueued = 0;
+		}
+	} while (!drained);
+
+	evdev_device_dispatch_events(device, ev, nqueued);
+
+	return rc;
+}
+
+static void
+evdev_device_dispatch_failed(struct evdev_device *device, int rc)
+{
+	struct libinput *libinput = evdev_libinput_context(device);
+
 	if (rc != -EAGAIN && rc != -EINTR) {
 		libinput_remove_source(libinput, device->source);
 		device->source = NULL;
 	}
 }
 
+/* Completion of a read issued by the io_uring read backend */
+static void
+evdev_device_dispatch_read(void *data, void *buf, ssize_t len)
+{
+	struct evdev_device *device = data;
+	struct input_event *ev = buf;
+	ssize_t nqueued;
+	int rc = -EAGAIN;
+
+	if (len < 0) {
+		evdev_device_dispatch_failed(device, len);
+		return;
+	}
+
+	if (len % sizeof(ev[0]) != 0) {
+		evdev_device_dispatch_failed(device, -EINVAL);
+		return;
+	}
+
+	nqueued = evdev_device_process_batch(device,
+					     ev,
+					     0,
+					     len / sizeof(ev[0]),
+					     &rc);
+	if (nqueued < 0) {
+		evdev_device_dispatch_failed(device, rc);
+		return;
+	}
+
+	/* A full buffer means there's more on the fd, including the rest
+	 * of an incomplete frame. Read it now, the next completion would
+	 * be out of order with a sync read. */
+	if (nqueued > 0 ||
+	    (size_t)len == EVDEV_READ_BATCH_SIZE * sizeof(ev[0])) {
+		rc = evdev_device_dispatch_batch(device, ev, nqueued);
+		evdev_device_dispatch_failed(device, rc);
+	}
+}
+
+static void
+evdev_device_dispatch(void *data)
+{
+	struct evdev_device *device = data;
+	int rc;
+
+	/* If the compositor is repainting, this function is called only once
+	 * per frame and we have to process all the events available on the
+	 * fd, otherwise there will be input lag.
+	 *
+	 * Events are read in batches straight from the fd, libevdev is
+	 * only used to track the device state and to resync after a
+	 * SYN_DROPPED. */
+	rc = evdev_device_dispatch_batch(device, NULL, 0);
+	evdev_device_dispatch_failed(device, rc);
+}
+
 static inline bool
 evdev_init_accel(struct evdev_device *device,
 		 enum libinput_config_accel_profile which)
@@ -1075,6 +1319,48 @@ evdev_accel_config_set_curve_point(struct libinput_device *libinput_device,
 	return LIBINPUT_CONFIG_STATUS_SUCCESS;
 }
 
+static enum libinput_config_status
+evdev_accel_config_set_curve(struct libinput_device *libinput_device,
+			     const double *a,
+			     const double *fa,
+			     size_t npoints)
+{
+	struct evdev_device *device = evdev_device(libinput_device);
+	struct motion_filter *filter = device->pointer.filter;
+
+	if (evdev_accel_config_get_profile(libinput_device) !=
+	    LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE)
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	if (!filter_set_curve(filter, a, fa, npoints))
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static enum libinput_config_status
+evdev_accel_config_set_curve_interpolation(
+		struct libinput_device *libinput_device,
+		enum libinput_config_accel_curve_interpolation interpolation)
+{
+	struct evdev_device *device = evdev_device(libinput_device);
+	struct motion_filter *filter = device->pointer.filter;
+
+	if (!filter_set_curve_interpolation(filter, interpolation))
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static enum libinput_config_accel_curve_interpolation
+evdev_accel_config_get_curve_interpolation(
+		struct libinput_device *libinput_device)
+{
+	struct evdev_device *device = evdev_device(libinput_device);
+
+	return filter_get_curve_interpolation(device->pointer.filter);
+}
+
 void
 evdev_device_init_pointer_acceleration(struct evdev_device *device,
 				       struct motion_filter *filter)
@@ -1093,6 +1379,9 @@ evdev_device_init_pointer_acceleration(struct evdev_device *device,
 		device->pointer.config.get_profile = evdev_accel_config_get_profile;
 		device->pointer.config.get_default_profile = evdev_accel_config_get_default_profile;
 		device->pointer.config.set_curve_point = evdev_accel_config_set_curve_point;
+		device->pointer.config.set_curve = evdev_accel_config_set_curve;
+		device->pointer.config.set_curve_interpolation = evdev_accel_config_set_curve_interpolation;
+		device->pointer.config.get_curve_interpolation = evdev_accel_config_get_curve_interpolation;
 		device->base.config.accel = &device->pointer.config;
 
 		default_speed = evdev_accel_config_get_default_speed(&device->base);
@@ -1200,8 +1489,8 @@ evdev_get_trackpoint_range(struct evdev_device *device)
 	if (!(device->tags & EVDEV_TAG_TRACKPOINT))
 		return DEFAULT_TRACKPOINT_RANGE;
 
-	prop = udev_device_get_property_value(device->udev_device,
-					      "LIBINPUT_ATTR_TRACKPOINT_RANGE");
+	prop = evdev_device_get_quirk_attr(device,
+					   EVDEV_QUIRK_ATTR_TRACKPOINT_RANGE);
 	if (prop) {
 		if (!safe_atoi(prop, &range) ||
 		    (range < 0.0 || range > 100)) {
@@ -1273,70 +1562,123 @@ evdev_read_dpi_prop(struct evdev_device *device)
 	return dpi;
 }
 
-static inline uint32_t
-evdev_read_model_flags(struct evdev_device *device)
+struct quirk_map {
+	const char *property;
+	enum evdev_device_model model;
+	int attr; /* enum evdev_quirk_attr or -1 for model flags */
+};
+
+static int
+quirk_map_cmp(const void *key, const void *elem)
 {
-	const struct model_map {
-		const char *property;
-		enum evdev_device_model model;
-	} model_map[] = {
-#define MODEL(name) { "LIBINPUT_MODEL_" #name, EVDEV_MODEL_##name }
-		MODEL(LENOVO_X230),
-		MODEL(LENOVO_X220_TOUCHPAD_FW81),
+	const struct quirk_map *m = elem;
+
+	return strcmp(key, m->property);
+}
+
+/* Read all model flags and attributes in a single pass over the
+ * device's udev properties instead of one property lookup each. */
+static inline void
+evdev_read_quirks(struct evdev_device *device)
+{
+	/* Sorted by property name for bsearch() */
+	static const struct quirk_map quirk_map[] = {
+#define MODEL(name) { "LIBINPUT_MODEL_" #name, EVDEV_MODEL_##name, -1 }
+#define ATTR(name) { "LIBINPUT_ATTR_" #name, EVDEV_MODEL_DEFAULT, EVDEV_QUIRK_ATTR_##name }
+		{ "ID_INPUT_TRACKBALL", EVDEV_MODEL_TRACKBALL, -1 },
+		ATTR(KEYBOARD_INTEGRATION),
+		ATTR(LID_SWITCH_RELIABILITY),
+		ATTR(PALM_PRESSURE_THRESHOLD),
+		ATTR(PALM_SIZE_THRESHOLD),
+		ATTR(PRESSURE_RANGE),
+		ATTR(RESOLUTION_HINT),
+		ATTR(SIZE_HINT),
+		ATTR(TOUCH_SIZE_RANGE),
+		ATTR(TPKBCOMBO_LAYOUT),
+		ATTR(TRACKPOINT_RANGE),
+		MODEL(ALPS_TOUCHPAD),
+		MODEL(APPLE_MAGICMOUSE),
+		MODEL(APPLE_TOUCHPAD),
+		MODEL(APPLE_TOUCHPAD_ONEBUTTON),
 		MODEL(CHROMEBOOK),
-		MODEL(SYSTEM76_BONOBO),
-		MODEL(SYSTEM76_GALAGO),
-		MODEL(SYSTEM76_KUDU),
 		MODEL(CLEVO_W740SU),
-		MODEL(APPLE_TOUCHPAD),
-		MODEL(WACOM_TOUCHPAD),
-		MODEL(ALPS_TOUCHPAD),
-		MODEL(SYNAPTICS_SERIAL_TOUCHPAD),
-		MODEL(JUMPING_SEMI_MT),
-		MODEL(LOGITECH_K400),
 		MODEL(CYBORG_RAT),
-		MODEL(HP_STREAM11_TOUCHPAD),
-		MODEL(LENOVO_T450_TOUCHPAD),
-		MODEL(TOUCHPAD_VISIBLE_MARKER),
-		MODEL(TRACKBALL),
-		MODEL(APPLE_MAGICMOUSE),
-		MODEL(HP8510_TOUCHPAD),
 		MODEL(HP6910_TOUCHPAD),
-		MODEL(HP_ZBOOK_STUDIO_G3),
+		MODEL(HP8510_TOUCHPAD),
 		MODEL(HP_PAVILION_DM4_TOUCHPAD),
-		MODEL(APPLE_TOUCHPAD_ONEBUTTON),
+		MODEL(HP_STREAM11_TOUCHPAD),
+		MODEL(HP_ZBOOK_STUDIO_G3),
+		MODEL(JUMPING_SEMI_MT),
+		MODEL(LENOVO_CARBON_X1_6TH),
+		MODEL(LENOVO_SCROLLPOINT),
+		MODEL(LENOVO_T450_TOUCHPAD),
+		MODEL(LENOVO_X220_TOUCHPAD_FW81),
+		MODEL(LENOVO_X230),
+		MODEL(LOGITECH_K400),
 		MODEL(LOGITECH_MARBLE_MOUSE),
-		MODEL(TABLET_NO_PROXIMITY_OUT),
 		MODEL(MS_NANO_TRANSCEIVER),
-		MODEL(TABLET_NO_TILT),
+		MODEL(SYNAPTICS_SERIAL_TOUCHPAD),
+		MODEL(SYSTEM76_BONOBO),
+		MODEL(SYSTEM76_GALAGO),
+		MODEL(SYSTEM76_KUDU),
 		MODEL(TABLET_MODE_NO_SUSPEND),
-		MODEL(LENOVO_CARBON_X1_6TH),
-		MODEL(LENOVO_SCROLLPOINT),
+		MODEL(TABLET_NO_PROXIMITY_OUT),
+		MODEL(TABLET_NO_TILT),
+		MODEL(TOUCHPAD_VISIBLE_MARKER),
+		MODEL(TRACKBALL),
+		MODEL(WACOM_TOUCHPAD),
 #undef MODEL
-		{ "ID_INPUT_TRACKBALL", EVDEV_MODEL_TRACKBALL },
-		{ NULL, EVDEV_MODEL_DEFAULT },
+#undef ATTR
 	};
-	const struct model_map *m = model_map;
-	uint32_t model_flags = 0;
+	const struct quirk_map *m;
+	struct udev_list_entry *entry;
 	uint32_t all_model_flags = 0;
+	size_t i;
+
+	for (i = 0; i < ARRAY_LENGTH(quirk_map); i++) {
+		m = &quirk_map[i];
+
+		assert(i == 0 ||
+		       strcmp(quirk_map[i - 1].property, m->property) < 0);
 
-	while (m->property) {
 		/* Check for flag re-use */
 		if (strneq("LIBINPUT_MODEL_", m->property, 15)) {
 			assert((all_model_flags & m->model) == 0);
 			all_model_flags |= m->model;
 		}
+	}
 
-		if (parse_udev_flag(device,
-				    device->udev_device,
-				    m->property)) {
-			evdev_log_debug(device, "tagged as %s\n", m->property);
-			model_flags |= m->model;
+	device->model_flags = 0;
+	memset(device->quirk_attrs, 0, sizeof(device->quirk_attrs));
+
+	udev_list_entry_foreach(entry,
+		udev_device_get_properties_list_entry(device->udev_device)) {
+		const char *property = udev_list_entry_get_name(entry);
+		const char *val = udev_list_entry_get_value(entry);
+
+		m = bsearch(property,
+			    quirk_map,
+			    ARRAY_LENGTH(quirk_map),
+			    sizeof(*m),
+			    quirk_map_cmp);
+		if (!m || !val)
+			continue;
+
+		if (m->attr != -1) {
+			device->quirk_attrs[m->attr] = val;
+			continue;
 		}
-		m++;
-	}
 
-	return model_flags;
+		if (streq(val, "1")) {
+			evdev_log_debug(device, "tagged as %s\n", property);
+			device->model_flags |= m->model;
+		} else if (!streq(val, "0")) {
+			evdev_log_error(device,
+					"property %s has invalid value '%s'\n",
+					property,
+					val);
+		}
+	}
 }
 
 static inline bool
@@ -1344,12 +1686,10 @@ evdev_read_attr_res_prop(struct evdev_device *device,
 			 size_t *xres,
 			 size_t *yres)
 {
-	struct udev_device *udev;
 	const char *res_prop;
 
-	udev = device->udev_device;
-	res_prop = udev_device_get_property_value(udev,
-						   "LIBINPUT_ATTR_RESOLUTION_HINT");
+	res_prop = evdev_device_get_quirk_attr(device,
+					       EVDEV_QUIRK_ATTR_RESOLUTION_HINT);
 	if (!res_prop)
 		return false;
 
@@ -1361,12 +1701,10 @@ evdev_read_attr_size_prop(struct evdev_device *device,
 			  size_t *size_x,
 			  size_t *size_y)
 {
-	struct udev_device *udev;
 	const char *size_prop;
 
-	udev = device->udev_device;
-	size_prop = udev_device_get_property_value(udev,
-						   "LIBINPUT_ATTR_SIZE_HINT");
+	size_prop = evdev_device_get_quirk_attr(device,
+						EVDEV_QUIRK_ATTR_SIZE_HINT);
 	if (!size_prop)
 		return false;
 
@@ -1987,33 +2325,39 @@ udev_device_should_be_ignored(struct udev_device *udev_device)
 	return value && !streq(value, "0");
 }
 
-struct evdev_device *
-evdev_device_create(struct libinput_seat *seat,
-		    struct udev_device *udev_device)
+bool
+evdev_device_can_open(struct libinput *libinput,
+		      struct udev_device *udev_device)
 {
-	struct libinput *libinput = seat->libinput;
-	struct evdev_device *device = NULL;
-	int rc;
-	int fd;
-	int unhandled_device = 0;
 	const char *devnode = udev_device_get_devnode(udev_device);
 	const char *sysname = udev_device_get_sysname(udev_device);
 
 	if (!devnode) {
 		log_info(libinput, "%s: no device node associated\n", sysname);
-		return NULL;
+		return false;
 	}
 
 	if (udev_device_should_be_ignored(udev_device)) {
 		log_debug(libinput, "%s: device is ignored\n", sysname);
-		return NULL;
+		return false;
 	}
 
-	/* Use non-blocking mode so that we can loop on read on
-	 * evdev_device_data() until all events on the fd are
-	 * read.  mtdev_get() also expects this. */
-	fd = open_restricted(libinput, devnode,
-			     O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	return true;
+}
+
+struct evdev_device *
+evdev_device_create(struct libinput_seat *seat,
+		    struct udev_device *udev_device)
+{
+	struct libinput *libinput = seat->libinput;
+	int fd;
+	const char *devnode = udev_device_get_devnode(udev_device);
+	const char *sysname = udev_device_get_sysname(udev_device);
+
+	if (!evdev_device_can_open(libinput, udev_device))
+		return NULL;
+
+	fd = open_restricted(libinput, devnode, EVDEV_OPEN_FLAGS);
 	if (fd < 0) {
 		log_info(libinput,
 			 "%s: opening input device '%s' failed (%s).\n",
@@ -2023,6 +2367,19 @@ evdev_device_create(struct libinput_seat *seat,
 		return NULL;
 	}
 
+	return evdev_device_create_from_fd(seat, udev_device, fd);
+}
+
+struct evdev_device *
+evdev_device_create_from_fd(struct libinput_seat *seat,
+			    struct udev_device *udev_device,
+			    int fd)
+{
+	struct libinput *libinput = seat->libinput;
+	struct evdev_device *device = NULL;
+	int rc;
+	int unhandled_device = 0;
+
 	if (!evdev_device_have_same_syspath(udev_device, fd))
 		goto err;
 
@@ -2055,7 +2412,7 @@ evdev_device_create(struct libinput_seat *seat,
 	device->scroll.wheel_click_angle =
 		evdev_read_wheel_click_props(device);
 	device->scroll.is_tilt = evdev_read_wheel_tilt_props(device);
-	device->model_flags = evdev_read_model_flags(device);
+	evdev_read_quirks(device);
 	device->dpi = DEFAULT_MOUSE_DPI;
 
 	/* at most 5 SYN_DROPPED log-messages per 30s */
@@ -2077,7 +2434,13 @@ evdev_device_create(struct libinput_seat *seat,
 	}
 
 	device->source =
-		libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
+		libinput_add_fd_reader(libinput,
+				       fd,
+				       EVDEV_READ_BATCH_SIZE *
+						sizeof(struct input_event),
+				       evdev_device_dispatch,
+				       evdev_device_dispatch_read,
+				       device);
 	if (!device->source)
 		goto err;
 
@@ -2532,6 +2895,10 @@ evdev_device_suspend(struct evdev_device *device)
 {
 	struct libinput *libinput = evdev_libinput_context(device);
 
+	/* suspended again while the seat is, stay suspended on resume */
+	if (device->seat_suspended)
+		device->resume_with_seat = false;
+
 	evdev_notify_suspended_device(device);
 
 	if (device->dispatch->interface->suspend)
@@ -2569,6 +2936,12 @@ evdev_device_resume(struct evdev_device *device)
 	if (device->was_removed)
 		return -ENODEV;
 
+	/* deferred until the seat resumes */
+	if (device->seat_suspended) {
+		device->resume_with_seat = true;
+		return 0;
+	}
+
 	devnode = udev_device_get_devnode(device->udev_device);
 	if (!devnode)
 		return -ENODEV;
@@ -2609,7 +2982,13 @@ evdev_device_resume(struct evdev_device *device)
 	} while (status == LIBEVDEV_READ_STATUS_SYNC);
 
 	device->source =
-		libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
+		libinput_add_fd_reader(libinput,
+				       fd,
+				       EVDEV_READ_BATCH_SIZE *
+						sizeof(struct input_event),
+				       evdev_device_dispatch,
+				       evdev_device_dispatch_read,
+				       device);
 	if (!device->source) {
 		mtdev_close_delete(device->mtdev);
 		return -ENOMEM;
@@ -2620,6 +2999,32 @@ evdev_device_resume(struct evdev_device *device)
 	return 0;
 }
 
+void
+evdev_device_seat_suspend(struct evdev_device *device)
+{
+	bool was_open = device->fd != -1;
+
+	if (was_open)
+		evdev_device_suspend(device);
+
+	device->seat_suspended = true;
+	device->resume_with_seat = was_open;
+}
+
+int
+evdev_device_seat_resume(struct evdev_device *device)
+{
+	bool resume = device->resume_with_seat;
+
+	device->seat_suspended = false;
+	device->resume_with_seat = false;
+
+	if (!resume)
+		return 0;
+
+	return evdev_device_resume(device);
+}
+
 void
 evdev_device_remove(struct evdev_device *device)
 {
@@ -35,6 +35,7 @@
 
 #include "libinput-private.h"
 #include "timer.h"
+#include "trace.h"
 #include "filter.h"
 
 /* The fake resolution value for abs devices without resolution */
@@ -133,6 +134,22 @@ enum evdev_device_model {
 	EVDEV_MODEL_LENOVO_SCROLLPOINT = (1 << 31),
 };
 
+/* LIBINPUT_ATTR_* properties assigned by 90-libinput-model-quirks.hwdb */
+enum evdev_quirk_attr {
+	EVDEV_QUIRK_ATTR_KEYBOARD_INTEGRATION,
+	EVDEV_QUIRK_ATTR_LID_SWITCH_RELIABILITY,
+	EVDEV_QUIRK_ATTR_PALM_PRESSURE_THRESHOLD,
+	EVDEV_QUIRK_ATTR_PALM_SIZE_THRESHOLD,
+	EVDEV_QUIRK_ATTR_PRESSURE_RANGE,
+	EVDEV_QUIRK_ATTR_RESOLUTION_HINT,
+	EVDEV_QUIRK_ATTR_SIZE_HINT,
+	EVDEV_QUIRK_ATTR_TOUCH_SIZE_RANGE,
+	EVDEV_QUIRK_ATTR_TPKBCOMBO_LAYOUT,
+	EVDEV_QUIRK_ATTR_TRACKPOINT_RANGE,
+
+	EVDEV_QUIRK_ATTR_COUNT,
+};
+
 enum evdev_button_scroll_state {
 	BUTTONSCROLL_IDLE,
 	BUTTONSCROLL_BUTTON_DOWN,	/* button is down */
@@ -190,11 +207,17 @@ struct evdev_device {
 	enum evdev_device_tags tags;
 	bool is_mt;
 	bool is_suspended;
+	/* suspended by libinput_suspend() but kept, see
+	 * LIBINPUT_SUSPEND_KEEP_DEVICES */
+	bool seat_suspended;
+	bool resume_with_seat; /* fd was open when the seat suspended */
 	int dpi; /* HW resolution */
 	int trackpoint_range; /* trackpoint max delta */
 	struct ratelimit syn_drop_limit; /* ratelimit for SYN_DROPPED logging */
 	struct ratelimit nonpointer_rel_limit; /* ratelimit for REL_* events from non-pointer devices */
 	uint32_t model_flags;
+	/* values point into udev_device's property list, NULL if unset */
+	const char *quirk_attrs[EVDEV_QUIRK_ATTR_COUNT];
 	struct mtdev *mtdev;
 
 	struct {
@@ -284,6 +307,13 @@ evdev_device(struct libinput_device *device)
 	return container_of(device, struct evdev_device, base);
 }
 
+static inline const char *
+evdev_device_get_quirk_attr(const struct evdev_device *device,
+			    enum evdev_quirk_attr attr)
+{
+	return device->quirk_attrs[attr];
+}
+
 #define EVDEV_UNHANDLED_DEVICE ((struct evdev_device *) 1)
 
 struct evdev_dispatch;
@@ -295,6 +325,15 @@ struct evdev_dispatch_interface {
 			struct input_event *event,
 			uint64_t time);
 
+	/* Process a whole frame of evdev input events, the last event is
+	 * the SYN_REPORT. time is the timestamp of the frame. Optional,
+	 * if NULL, process is called for each event instead. */
+	void (*process_frame)(struct evdev_dispatch *dispatch,
+			      struct evdev_device *device,
+			      struct input_event *events,
+			      size_t nevents,
+			      uint64_t time);
+
 	/* Device is being suspended */
 	void (*suspend)(struct evdev_dispatch *dispatch,
 			struct evdev_device *device);
@@ -364,10 +403,25 @@ evdev_verify_dispatch_type(struct evdev_dispatch *dispatch,
 		abort();
 }
 
+/* Use non-blocking mode so that we can loop on read on
+ * evdev_device_data() until all events on the fd are
+ * read.  mtdev_get() also expects this. */
+#define EVDEV_OPEN_FLAGS (O_RDWR | O_NONBLOCK | O_CLOEXEC)
+
+bool
+evdev_device_can_open(struct libinput *libinput,
+		      struct udev_device *udev_device);
+
 struct evdev_device *
 evdev_device_create(struct libinput_seat *seat,
 		    struct udev_device *device);
 
+/* Takes ownership of fd, it is closed on failure */
+struct evdev_device *
+evdev_device_create_from_fd(struct libinput_seat *seat,
+			    struct udev_device *device,
+			    int fd);
+
 void
 evdev_transform_absolute(struct evdev_device *device,
 			 struct device_coords *point);
@@ -559,6 +613,12 @@ evdev_stop_scroll(struct evdev_device *device,
 void
 evdev_device_remove(struct evdev_device *device);
 
+void
+evdev_device_seat_suspend(struct evdev_device *device);
+
+int
+evdev_device_seat_resume(struct evdev_device *device);
+
 void
 evdev_device_destroy(struct evdev_device *device);
 
@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <limits.h>
 #include <math.h>
 
@@ -35,19 +36,49 @@
 #include "libinput-util.h"
 #include "filter-private.h"
 
+/* No useful curve comes close to this, it merely limits how much memory
+ * a caller can make us allocate */
+#define CUSTOM_MAX_POINTS 65536
+#define CUSTOM_MAX_X 50000 /* units/ms */
+
 struct acceleration_curve_point {
 	double x, fx;
+	double m; /* tangent for cubic interpolation */
 };
 
 struct custom_accelerator {
 	struct motion_filter base;
-	struct acceleration_curve_point points[32];
+	struct acceleration_curve_point *points; /* sorted by x */
 	size_t npoints;
+	size_t points_size;
+
+	enum libinput_config_accel_curve_interpolation interpolation;
 
 	double last_velocity;
 	struct pointer_trackers trackers;
 };
 
+/**
+ * Find the segment [i, i + 1] with points[i].x < x <= points[i + 1].x.
+ * x must be within the curve.
+ */
+static inline size_t
+custom_find_segment(const struct custom_accelerator *f, double x)
+{
+	size_t lo = 0, hi = f->npoints - 1;
+
+	while (hi - lo > 1) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (f->points[mid].x < x)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
 double
 custom_accel_profile(struct motion_filter *filter,
 		     void *data,
@@ -56,7 +87,9 @@ custom_accel_profile(struct motion_filter *filter,
 {
 	struct custom_accelerator *f =
 		(struct custom_accelerator*)filter;
-	double fx = 1;
+	const struct acceleration_curve_point *p0, *p1;
+	double h, t, delta;
+	size_t i;
 
 	speed_in *= 1000;
 
@@ -66,41 +99,104 @@ custom_accel_profile(struct motion_filter *filter,
 	if (f->points[0].x >= speed_in)
 		return f->points[0].fx;
 
-	for (size_t i = 0; i < f->npoints - 1; i++) {
-		double a, b, fa, fb;
-		double k, d;
+	if (f->points[f->npoints - 1].x <= speed_in)
+		return f->points[f->npoints - 1].fx;
+
+	i = custom_find_segment(f, speed_in);
+	p0 = &f->points[i];
+	p1 = &f->points[i + 1];
+	h = p1->x - p0->x;
+	t = (speed_in - p0->x) / h;
+	delta = p1->fx - p0->fx;
+
+	if (f->interpolation ==
+	    LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_MONOTONE_CUBIC) {
+		/* cubic Hermite spline with the precalculated tangents,
+		 * written as the linear interpolation plus a correction so
+		 * that a flat segment stays exactly flat */
+		double c0 = h * p0->m - delta,
+		       c1 = h * p1->m - delta;
+
+		return p0->fx + t * delta +
+		       t * (1 - t) * ((1 - t) * c0 - t * c1);
+	}
 
-		if (f->points[i + 1].x < speed_in)
-			continue;
+	return p0->fx + t * delta;
+}
 
-		/*
-		   We haves points f(i), f(i+1), defining two points on the
-		   curve. linear function in the form y = kx+d:
+/**
+ * Calculate the tangents for monotone cubic interpolation with the
+ * Fritsch-Carlson method: the curve between two points never overshoots
+ * them, so a monotonic set of points gives a monotonic curve.
+ */
+static void
+custom_update_tangents(struct custom_accelerator *f)
+{
+	struct acceleration_curve_point *p = f->points;
+	size_t n = f->npoints;
+	double d, d_prev, alpha, beta, s, tau;
+	size_t i;
+
+	if (n < 2) {
+		if (n == 1)
+			p[0].m = 0.0;
+		return;
+	}
 
-		   y = kx + d
+	/* secants between the points, averaged for the inner points unless
+	 * the curve changes direction there */
+	d_prev = (p[1].fx - p[0].fx) / (p[1].x - p[0].x);
+	p[0].m = d_prev;
+	for (i = 1; i < n - 1; i++) {
+		d = (p[i + 1].fx - p[i].fx) / (p[i + 1].x - p[i].x);
+		if (d * d_prev <= 0.0)
+			p[i].m = 0.0;
+		else
+			p[i].m = (d + d_prev) / 2;
+		d_prev = d;
+	}
+	p[n - 1].m = d_prev;
+
+	/* limit the tangents so the segments can't overshoot */
+	for (i = 0; i < n - 1; i++) {
+		d = (p[i + 1].fx - p[i].fx) / (p[i + 1].x - p[i].x);
+		if (d == 0.0) {
+			p[i].m = 0.0;
+			p[i + 1].m = 0.0;
+			continue;
+		}
 
-		   y1 = kx1 + d -> d = y1 - kx1
-		   y2 = kx2 + d -> d = y2 - kx2
+		alpha = p[i].m / d;
+		beta = p[i + 1].m / d;
+		s = alpha * alpha + beta * beta;
+		if (s > 9.0) {
+			tau = 3.0 / sqrt(s);
+			p[i].m = tau * alpha * d;
+			p[i + 1].m = tau * beta * d;
+		}
+	}
+}
 
-		   y1 - kx1 = y2 - kx2
-		   y1 - y2 = kx1 - kx2
-		   k = y1-y2/(x1 - x2)
+static bool
+custom_reserve_points(struct custom_accelerator *f, size_t npoints)
+{
+	struct acceleration_curve_point *points;
+	size_t size = f->points_size ? f->points_size : 32;
 
-		 */
-		a  = f->points[i].x;
-		fa = f->points[i].fx;
-		b  = f->points[i+1].x;
-		fb = f->points[i+1].fx;
+	if (npoints <= f->points_size)
+		return true;
 
-		k = (fa - fb)/(a - b);
-		d = fa - k * a;
+	while (size < npoints)
+		size *= 2;
 
-		fx = k * speed_in + d;
+	points = realloc(f->points, size * sizeof(*points));
+	if (!points)
+		return false;
 
-		return fx;
-	}
+	f->points = points;
+	f->points_size = size;
 
-	return f->points[f->npoints - 1].fx;
+	return true;
 }
 
 static struct normalized_coords
@@ -148,6 +244,7 @@ custom_accelerator_destroy(struct motion_filter *filter)
 		(struct custom_accelerator*)filter;
 
 	trackers_free(&accel_filter->trackers);
+	free(accel_filter->points);
 	free(accel_filter);
 }
 
@@ -157,41 +254,102 @@ custom_accelerator_set_curve_point(struct motion_filter *filter,
 {
 	struct custom_accelerator *f =
 		(struct custom_accelerator*)filter;
+	size_t i;
+
+	if (a < 0 || a > CUSTOM_MAX_X)
+		return false;
+
+	/* first point with x >= a */
+	if (f->npoints == 0 || f->points[0].x >= a)
+		i = 0;
+	else if (f->points[f->npoints - 1].x < a)
+		i = f->npoints;
+	else
+		i = custom_find_segment(f, a) + 1;
+
+	if (i < f->npoints && f->points[i].x == a) {
+		f->points[i].fx = fa;
+	} else {
+		if (f->npoints == CUSTOM_MAX_POINTS ||
+		    !custom_reserve_points(f, f->npoints + 1))
+			return false;
+
+		memmove(&f->points[i + 1],
+			&f->points[i],
+			(f->npoints - i) * sizeof(*f->points));
+		f->points[i].x = a;
+		f->points[i].fx = fa;
+		f->npoints++;
+	}
+
+	custom_update_tangents(f);
+
+	return true;
+}
+
+static bool
+custom_accelerator_set_curve(struct motion_filter *filter,
+			     const double *a,
+			     const double *fa,
+			     size_t npoints)
+{
+	struct custom_accelerator *f =
+		(struct custom_accelerator*)filter;
+	size_t i;
 
-	if (f->npoints == ARRAY_LENGTH(f->points))
+	if (npoints > CUSTOM_MAX_POINTS)
 		return false;
 
-	if (a < 0 || a > 50000)
+	for (i = 0; i < npoints; i++) {
+		if (a[i] < 0 || a[i] > CUSTOM_MAX_X)
+			return false;
+		if (i > 0 && a[i] <= a[i - 1])
+			return false;
+	}
+
+	if (!custom_reserve_points(f, npoints))
 		return false;
 
-	if (f->npoints == 0) {
-		f->points[0].x = a;
-		f->points[0].fx = fa;
-		f->npoints = 1;
-		return true;
-	} else if (f->points[f->npoints - 1].x < a) {
-		f->points[f->npoints].x = a;
-		f->points[f->npoints].fx = fa;
-		f->npoints++;
-		return true;
+	for (i = 0; i < npoints; i++) {
+		f->points[i].x = a[i];
+		f->points[i].fx = fa[i];
 	}
+	f->npoints = npoints;
 
-	for (size_t i = 0; i < f->npoints; i++) {
-		if (f->points[i].x == a) {
-			f->points[i].fx = fa;
-			break;
-		} else if (f->points[i].x > a) {
-			f->npoints++;
-			for (size_t j = f->npoints - 1; j > i; j--)
-				f->points[j] = f->points[j-1];
-			f->points[i] = (struct acceleration_curve_point){ a, fa };
-			break;
-		}
+	custom_update_tangents(f);
+
+	return true;
+}
+
+static bool
+custom_accelerator_set_curve_interpolation(struct motion_filter *filter,
+		enum libinput_config_accel_curve_interpolation interpolation)
+{
+	struct custom_accelerator *f =
+		(struct custom_accelerator*)filter;
+
+	switch (interpolation) {
+	case LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR:
+	case LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_MONOTONE_CUBIC:
+		break;
+	default:
+		return false;
 	}
 
+	f->interpolation = interpolation;
+
 	return true;
 }
 
+static enum libinput_config_accel_curve_interpolation
+custom_accelerator_get_curve_interpolation(struct motion_filter *filter)
+{
+	struct custom_accelerator *f =
+		(struct custom_accelerator*)filter;
+
+	return f->interpolation;
+}
+
 struct motion_filter_interface accelerator_interface_custom = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE,
 	.filter = custom_accelerator_filter,
@@ -200,6 +358,9 @@ struct motion_filter_interface accelerator_interface_custom = {
 	.destroy = custom_accelerator_destroy,
 	.set_speed = custom_accelerator_set_speed,
 	.set_curve_point = custom_accelerator_set_curve_point,
+	.set_curve = custom_accelerator_set_curve,
+	.set_curve_interpolation = custom_accelerator_set_curve_interpolation,
+	.get_curve_interpolation = custom_accelerator_get_curve_interpolation,
 };
 
 struct motion_filter *
@@ -211,6 +372,7 @@ create_pointer_accelerator_filter_custom_device_speed(void)
 	trackers_init(&filter->trackers);
 
 	filter->base.interface = &accelerator_interface_custom;
+	filter->interpolation = LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR;
 
 	return &filter->base;
 }
@@ -62,6 +62,26 @@ accelerator_filter_flat(struct motion_filter *filter,
 	return accelerated;
 }
 
+static void
+accelerator_filter_flat_batch(struct motion_filter *filter,
+			      const struct device_float_coords *unaccelerated,
+			      const uint64_t *times,
+			      struct normalized_coords *accelerated,
+			      size_t nevents,
+			      void *data)
+{
+	struct pointer_accelerator_flat *accel_filter =
+		(struct pointer_accelerator_flat *)filter;
+	double factor = accel_filter->factor; /* unitless factor */
+	size_t i;
+
+	/* No state, every delta is independent of the others */
+	for (i = 0; i < nevents; i++) {
+		accelerated[i].x = factor * unaccelerated[i].x;
+		accelerated[i].y = factor * unaccelerated[i].y;
+	}
+}
+
 static struct normalized_coords
 accelerator_filter_noop_flat(struct motion_filter *filter,
 			     const struct device_float_coords *unaccelerated,
@@ -105,6 +125,7 @@ accelerator_destroy_flat(struct motion_filter *filter)
 struct motion_filter_interface accelerator_interface_flat = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_FLAT,
 	.filter = accelerator_filter_flat,
+	.filter_batch = accelerator_filter_flat_batch,
 	.filter_constant = accelerator_filter_noop_flat,
 	.restart = NULL,
 	.destroy = accelerator_destroy_flat,
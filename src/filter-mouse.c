@@ -152,6 +152,40 @@ accelerator_filter_pre_normalized(struct motion_filter *filter,
 	return normalized;
 }
 
+static void
+accelerator_filter_pre_normalized_batch(struct motion_filter *filter,
+					const struct device_float_coords *unaccelerated,
+					const uint64_t *times,
+					struct normalized_coords *accelerated,
+					size_t nevents,
+					void *data)
+{
+	struct pointer_accelerator *accel =
+		(struct pointer_accelerator *) filter;
+	struct device_float_coords converted;
+	double accel_value; /* unitless factor */
+	size_t i;
+
+	/* The normalization doesn't depend on previous events, do it in
+	 * one pass over the whole batch */
+	for (i = 0; i < nevents; i++)
+		accelerated[i] = normalize_for_dpi(&unaccelerated[i],
+						   accel->dpi);
+
+	/* The velocity does, so this pass is strictly sequential */
+	for (i = 0; i < nevents; i++) {
+		converted.x = accelerated[i].x;
+		converted.y = accelerated[i].y;
+
+		accel_value = calculate_acceleration_factor(accel,
+							    &converted,
+							    data,
+							    times[i]);
+		accelerated[i].x = accel_value * converted.x;
+		accelerated[i].y = accel_value * converted.y;
+	}
+}
+
 /**
  * Generic filter that does nothing beyond converting from the device's
  * native dpi into normalized coordinates.
@@ -303,6 +337,7 @@ pointer_accel_profile_linear(struct motion_filter *filter,
 struct motion_filter_interface accelerator_interface = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE,
 	.filter = accelerator_filter_pre_normalized,
+	.filter_batch = accelerator_filter_pre_normalized_batch,
 	.filter_constant = accelerator_filter_noop,
 	.restart = accelerator_restart,
 	.destroy = accelerator_destroy,
@@ -34,6 +34,14 @@ struct motion_filter_interface {
 			   struct motion_filter *filter,
 			   const struct device_float_coords *unaccelerated,
 			   void *data, uint64_t time);
+	/* optional, filter_dispatch_batch() falls back to calling
+	 * filter() for each delta */
+	void (*filter_batch)(struct motion_filter *filter,
+			     const struct device_float_coords *unaccelerated,
+			     const uint64_t *times,
+			     struct normalized_coords *accelerated,
+			     size_t nevents,
+			     void *data);
 	struct normalized_coords (*filter_constant)(
 			   struct motion_filter *filter,
 			   const struct device_float_coords *unaccelerated,
@@ -46,6 +54,14 @@ struct motion_filter_interface {
 			  double speed_adjustment);
 	bool (*set_curve_point)(struct motion_filter *filter,
 				double a, double fa);
+	bool (*set_curve)(struct motion_filter *filter,
+			  const double *a,
+			  const double *fa,
+			  size_t npoints);
+	bool (*set_curve_interpolation)(struct motion_filter *filter,
+			enum libinput_config_accel_curve_interpolation interpolation);
+	enum libinput_config_accel_curve_interpolation
+		(*get_curve_interpolation)(struct motion_filter *filter);
 };
 
 struct motion_filter {
@@ -54,7 +70,10 @@ struct motion_filter {
 };
 
 struct pointer_tracker {
-	struct device_float_coords delta; /* delta to most recent event */
+	/* running sum of all deltas up to and including this event, the
+	 * delta to the most recent event is the difference between the two
+	 * sums */
+	struct device_float_coords sum;
 	uint64_t time;  /* us */
 	uint32_t dir;
 };
@@ -65,11 +84,22 @@ struct pointer_delta_smoothener {
 	uint64_t value;
 };
 
+/* The tracker ring starts with the minimum size and is resized between
+ * the minimum and the maximum to follow the device's report rate, see
+ * trackers_update_size(). Both sizes must be powers of two. */
+#define TRACKERS_MIN 16
+#define TRACKERS_MAX 128
+
 struct pointer_trackers {
-	struct pointer_tracker *trackers;
-	size_t ntrackers;
+	struct pointer_tracker trackers[TRACKERS_MAX];
+	size_t ntrackers; /* always a power of two */
 	unsigned int cur_tracker;
 
+	/* averaged interval between events in us, and the number of
+	 * intervals seen since the ring was last resized */
+	uint64_t interval;
+	unsigned int nintervals;
+
 	struct pointer_delta_smoothener *smoothener;
 };
 
@@ -84,8 +114,14 @@ trackers_feed(struct pointer_trackers *trackers,
 	      const struct device_float_coords *delta,
 	      uint64_t time);
 
-struct pointer_tracker *
-trackers_by_offset(struct pointer_trackers *trackers, unsigned int offset);
+static inline struct pointer_tracker *
+trackers_by_offset(struct pointer_trackers *trackers, unsigned int offset)
+{
+	unsigned int index = (trackers->cur_tracker - offset) &
+			     (trackers->ntrackers - 1);
+
+	return &trackers->trackers[index];
+}
 
 double
 trackers_velocity(struct pointer_trackers *trackers, uint64_t time);
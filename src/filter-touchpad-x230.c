@@ -224,20 +224,8 @@ accelerator_restart_x230(struct motion_filter *filter,
 {
 	struct pointer_accelerator_x230 *accel =
 		(struct pointer_accelerator_x230 *) filter;
-	unsigned int offset;
-	struct pointer_tracker *tracker;
-
-	for (offset = 1; offset < accel->trackers.ntrackers; offset++) {
-		tracker = trackers_by_offset(&accel->trackers, offset);
-		tracker->time = 0;
-		tracker->dir = 0;
-		tracker->delta.x = 0;
-		tracker->delta.y = 0;
-	}
-
-	tracker = trackers_by_offset(&accel->trackers, 0);
-	tracker->time = time;
-	tracker->dir = UNDEFINED_DIRECTION;
+
+	trackers_reset(&accel->trackers, time);
 }
 
 static void
@@ -246,7 +234,7 @@ accelerator_destroy_x230(struct motion_filter *filter)
 	struct pointer_accelerator_x230 *accel =
 		(struct pointer_accelerator_x230 *) filter;
 
-	free(accel->trackers.trackers);
+	trackers_free(&accel->trackers);
 	free(accel);
 }
 
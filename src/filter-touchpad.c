@@ -147,6 +147,39 @@ accelerator_filter_post_normalized(struct motion_filter *filter,
 	return normalize_for_dpi(&accelerated, accel->dpi);
 }
 
+static void
+accelerator_filter_post_normalized_batch(struct motion_filter *filter,
+					 const struct device_float_coords *unaccelerated,
+					 const uint64_t *times,
+					 struct normalized_coords *accelerated,
+					 size_t nevents,
+					 void *data)
+{
+	struct touchpad_accelerator *accel =
+		(struct touchpad_accelerator *) filter;
+	struct device_float_coords delta;
+	double accel_value; /* unitless factor */
+	size_t i;
+
+	/* The velocity depends on the previous events, so this pass is
+	 * strictly sequential. The output is still in device units. */
+	for (i = 0; i < nevents; i++) {
+		accel_value = calculate_acceleration_factor(accel,
+							    &unaccelerated[i],
+							    data,
+							    times[i]);
+		accelerated[i].x = accel_value * unaccelerated[i].x;
+		accelerated[i].y = accel_value * unaccelerated[i].y;
+	}
+
+	/* Normalize afterwards, in one pass over the whole batch */
+	for (i = 0; i < nevents; i++) {
+		delta.x = accelerated[i].x;
+		delta.y = accelerated[i].y;
+		accelerated[i] = normalize_for_dpi(&delta, accel->dpi);
+	}
+}
+
 static bool
 touchpad_accelerator_set_speed(struct motion_filter *filter,
 		      double speed_adjustment)
@@ -287,6 +320,7 @@ touchpad_accel_profile_linear(struct motion_filter *filter,
 struct motion_filter_interface accelerator_interface_touchpad = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE,
 	.filter = accelerator_filter_post_normalized,
+	.filter_batch = accelerator_filter_post_normalized_batch,
 	.filter_constant = touchpad_constant_filter,
 	.restart = touchpad_accelerator_restart,
 	.destroy = touchpad_accelerator_destroy,
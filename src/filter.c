@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <limits.h>
 #include <math.h>
 
@@ -46,6 +47,33 @@ filter_dispatch(struct motion_filter *filter,
 	return filter->interface->filter(filter, unaccelerated, data, time);
 }
 
+void
+filter_dispatch_batch(struct motion_filter *filter,
+		      const struct device_float_coords *unaccelerated,
+		      const uint64_t *times,
+		      struct normalized_coords *accelerated,
+		      size_t nevents,
+		      void *data)
+{
+	size_t i;
+
+	if (filter->interface->filter_batch) {
+		filter->interface->filter_batch(filter,
+						unaccelerated,
+						times,
+						accelerated,
+						nevents,
+						data);
+		return;
+	}
+
+	for (i = 0; i < nevents; i++)
+		accelerated[i] = filter->interface->filter(filter,
+							   &unaccelerated[i],
+							   data,
+							   times[i]);
+}
+
 struct normalized_coords
 filter_dispatch_constant(struct motion_filter *filter,
 			 const struct device_float_coords *unaccelerated,
@@ -99,22 +127,61 @@ filter_set_curve_point(struct motion_filter *filter, double a, double fa)
 	return filter->interface->set_curve_point(filter, a, fa);
 }
 
+bool
+filter_set_curve(struct motion_filter *filter,
+		 const double *a,
+		 const double *fa,
+		 size_t npoints)
+{
+	if (!filter->interface->set_curve)
+		return false;
+
+	return filter->interface->set_curve(filter, a, fa, npoints);
+}
+
+bool
+filter_set_curve_interpolation(struct motion_filter *filter,
+		enum libinput_config_accel_curve_interpolation interpolation)
+{
+	if (!filter->interface->set_curve_interpolation)
+		return false;
+
+	return filter->interface->set_curve_interpolation(filter,
+							  interpolation);
+}
+
+enum libinput_config_accel_curve_interpolation
+filter_get_curve_interpolation(struct motion_filter *filter)
+{
+	if (!filter->interface->get_curve_interpolation)
+		return LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR;
+
+	return filter->interface->get_curve_interpolation(filter);
+}
+
+/* Once the running sum gets this large, rebase it to keep the
+ * subtraction in calculate_trackers_velocity() precise */
+#define TRACKER_SUM_REBASE	1e6
+
+/* The history the trackers aim to keep, 16 events at 1000Hz. Faster
+ * devices get a bigger ring so their velocity is averaged over a similar
+ * time rather than over fewer milliseconds */
+#define TRACKERS_WINDOW		ms2us(16)
+
 void
 trackers_init(struct pointer_trackers *trackers)
 {
-	const int ntrackers = 16;
-
-	trackers->trackers = zalloc(ntrackers *
-				    sizeof(*trackers->trackers));
-	trackers->ntrackers = ntrackers;
+	memset(trackers->trackers, 0, sizeof(trackers->trackers));
+	trackers->ntrackers = TRACKERS_MIN;
 	trackers->cur_tracker = 0;
+	trackers->interval = 0;
+	trackers->nintervals = 0;
 	trackers->smoothener = NULL;
 }
 
 void
 trackers_free(struct pointer_trackers *trackers)
 {
-	free(trackers->trackers);
 	free(trackers->smoothener);
 }
 
@@ -129,13 +196,110 @@ trackers_reset(struct pointer_trackers *trackers,
 		tracker = trackers_by_offset(trackers, offset);
 		tracker->time = 0;
 		tracker->dir = 0;
-		tracker->delta.x = 0;
-		tracker->delta.y = 0;
+		tracker->sum.x = 0;
+		tracker->sum.y = 0;
 	}
 
 	tracker = trackers_by_offset(trackers, 0);
 	tracker->time = time;
 	tracker->dir = UNDEFINED_DIRECTION;
+	tracker->sum.x = 0;
+	tracker->sum.y = 0;
+}
+
+static void
+trackers_rebase(struct pointer_trackers *trackers)
+{
+	struct device_float_coords base = trackers_by_offset(trackers, 0)->sum;
+	unsigned int i;
+
+	for (i = 0; i < trackers->ntrackers; i++) {
+		trackers->trackers[i].sum.x -= base.x;
+		trackers->trackers[i].sum.y -= base.y;
+	}
+}
+
+/* Grow the ring to ntrackers entries, keeping the existing history in
+ * order. The new entries are the oldest and are treated as timed out */
+static void
+trackers_grow(struct pointer_trackers *trackers, size_t ntrackers)
+{
+	struct pointer_tracker *ts = trackers->trackers;
+	size_t old = trackers->ntrackers;
+	unsigned int tail = trackers->cur_tracker + 1;
+
+	assert(ntrackers > old && ntrackers <= TRACKERS_MAX);
+
+	/* Entries after cur_tracker wrapped around in the old ring, move
+	 * them to the end of the new one */
+	memmove(&ts[tail + ntrackers - old],
+		&ts[tail],
+		(old - tail) * sizeof(*ts));
+	memset(&ts[tail], 0, (ntrackers - old) * sizeof(*ts));
+
+	trackers->ntrackers = ntrackers;
+}
+
+/* Shrink the ring to ntrackers entries, keeping the most recent
+ * history in order */
+static void
+trackers_shrink(struct pointer_trackers *trackers, size_t ntrackers)
+{
+	struct pointer_tracker keep[TRACKERS_MAX / 2];
+	unsigned int offset;
+
+	assert(ntrackers < trackers->ntrackers && ntrackers >= TRACKERS_MIN);
+
+	for (offset = 0; offset < ntrackers; offset++)
+		keep[ntrackers - 1 - offset] =
+			*trackers_by_offset(trackers, offset);
+
+	memcpy(trackers->trackers, keep, ntrackers * sizeof(*keep));
+	trackers->cur_tracker = ntrackers - 1;
+	trackers->ntrackers = ntrackers;
+}
+
+static void
+trackers_update_size(struct pointer_trackers *trackers,
+		     uint64_t interval)
+{
+	size_t ntrackers = trackers->ntrackers;
+	uint64_t average;
+
+	/* Zero intervals are multiple events in the same frame, intervals
+	 * beyond the window are pauses in the motion. Neither tells us
+	 * anything about the report rate. */
+	if (interval == 0 || interval >= TRACKERS_WINDOW)
+		return;
+
+	if (trackers->interval == 0)
+		trackers->interval = interval;
+	else
+		trackers->interval = (trackers->interval * 7 + interval) / 8;
+
+	/* Only resize once we've seen a whole ring's worth of events, a
+	 * single burst doesn't make a high-rate device */
+	if (++trackers->nintervals < ntrackers)
+		return;
+
+	trackers->nintervals = 0;
+	average = trackers->interval;
+
+	/* Grow when the ring covers less than half the window and shrink
+	 * when half the ring would still cover all of it. The gap keeps
+	 * the report rate jitter of a device at a boundary, e.g. a
+	 * 1000Hz mouse, from resizing the ring back and forth. */
+	while (ntrackers < TRACKERS_MAX &&
+	       average * ntrackers * 2 < TRACKERS_WINDOW)
+		ntrackers *= 2;
+	while (ntrackers > TRACKERS_MIN &&
+	       average * ntrackers / 2 >= TRACKERS_WINDOW)
+		ntrackers /= 2;
+
+	if (ntrackers > trackers->ntrackers)
+		trackers_grow(trackers, ntrackers);
+	else if (ntrackers < trackers->ntrackers)
+		trackers_shrink(trackers, ntrackers);
 }
 
 void
@@ -143,51 +307,51 @@ trackers_feed(struct pointer_trackers *trackers,
 	      const struct device_float_coords *delta,
 	      uint64_t time)
 {
-	unsigned int i, current;
-	struct pointer_tracker *ts = trackers->trackers;
+	struct pointer_tracker *previous, *current;
 
 	assert(trackers->ntrackers);
 
-	for (i = 0; i < trackers->ntrackers; i++) {
-		ts[i].delta.x += delta->x;
-		ts[i].delta.y += delta->y;
-	}
+	previous = trackers_by_offset(trackers, 0);
+	if (time >= previous->time)
+		trackers_update_size(trackers, time - previous->time);
 
-	current = (trackers->cur_tracker + 1) % trackers->ntrackers;
-	trackers->cur_tracker = current;
+	if (fabs(previous->sum.x) > TRACKER_SUM_REBASE ||
+	    fabs(previous->sum.y) > TRACKER_SUM_REBASE)
+		trackers_rebase(trackers);
 
-	ts[current].delta.x = 0.0;
-	ts[current].delta.y = 0.0;
-	ts[current].time = time;
-	ts[current].dir = device_float_get_direction(*delta);
-}
+	trackers->cur_tracker = (trackers->cur_tracker + 1) &
+				(trackers->ntrackers - 1);
+	current = trackers_by_offset(trackers, 0);
 
-struct pointer_tracker *
-trackers_by_offset(struct pointer_trackers *trackers, unsigned int offset)
-{
-	unsigned int index =
-		(trackers->cur_tracker + trackers->ntrackers - offset)
-		% trackers->ntrackers;
-	return &trackers->trackers[index];
+	current->sum.x = previous->sum.x + delta->x;
+	current->sum.y = previous->sum.y + delta->y;
+	current->time = time;
+	current->dir = device_float_get_direction(*delta);
 }
 
 static double
-calculate_trackers_velocity(struct pointer_tracker *tracker,
-			   uint64_t time,
-			   struct pointer_delta_smoothener *smoothener)
+calculate_trackers_velocity(const struct pointer_tracker *current,
+			    const struct pointer_tracker *tracker,
+			    uint64_t time,
+			    struct pointer_delta_smoothener *smoothener)
 {
+	/* The delta to the most recent event is the difference of the two
+	 * running sums */
+	double dx = current->sum.x - tracker->sum.x;
+	double dy = current->sum.y - tracker->sum.y;
 	uint64_t tdelta = time - tracker->time + 1;
 
 	if (smoothener && tdelta < smoothener->threshold)
 		tdelta = smoothener->value;
 
-	return hypot(tracker->delta.x, tracker->delta.y) /
-	       (double)tdelta; /* units/us */
+	/* deltas are nowhere near the range where hypot() would matter */
+	return sqrt(dx * dx + dy * dy) / (double)tdelta; /* units/us */
 }
 
 static double
-trackers_velocity_after_timeout(struct pointer_tracker *tracker,
-				 struct pointer_delta_smoothener *smoothener)
+trackers_velocity_after_timeout(const struct pointer_tracker *current,
+				const struct pointer_tracker *tracker,
+				struct pointer_delta_smoothener *smoothener)
 {
 	/* First movement after timeout needs special handling.
 	 *
@@ -200,9 +364,10 @@ trackers_velocity_after_timeout(struct pointer_tracker *tracker,
 	 * for really slow movements but provides much more useful initial
 	 * movement in normal use-cases (pause, move, pause, move)
 	 */
-	return calculate_trackers_velocity(tracker,
-					  tracker->time + MOTION_TIMEOUT,
-					  smoothener);
+	return calculate_trackers_velocity(current,
+					   tracker,
+					   tracker->time + MOTION_TIMEOUT,
+					   smoothener);
 }
 
 /**
@@ -216,17 +381,20 @@ double
 trackers_velocity(struct pointer_trackers *trackers, uint64_t time)
 {
 	const double MAX_VELOCITY_DIFF = v_ms2us(1); /* units/us */
-	struct pointer_tracker *tracker;
+	struct pointer_delta_smoothener *smoothener = trackers->smoothener;
+	const struct pointer_tracker *current = trackers_by_offset(trackers, 0);
+	const struct pointer_tracker *tracker;
 	double velocity;
 	double result = 0.0;
 	double initial_velocity = 0.0;
 	double velocity_diff;
 	unsigned int offset;
 
-	unsigned int dir = trackers_by_offset(trackers, 0)->dir;
+	unsigned int dir = current->dir;
 
 	/* Find least recent vector within a timelimit, maximum velocity diff
-	 * and direction threshold. */
+	 * and direction threshold. Time and direction are checked first so
+	 * we don't calculate a velocity for a tracker we then discard. */
 	for (offset = 1; offset < trackers->ntrackers; offset++) {
 		tracker = trackers_by_offset(trackers, offset);
 
@@ -238,25 +406,30 @@ trackers_velocity(struct pointer_trackers *trackers, uint64_t time)
 		if (time - tracker->time > MOTION_TIMEOUT) {
 			if (offset == 1)
 				result = trackers_velocity_after_timeout(
-							  tracker,
-							  trackers->smoothener);
+								 current,
+								 tracker,
+								 smoothener);
 			break;
 		}
 
-		velocity = calculate_trackers_velocity(tracker,
-						      time,
-						      trackers->smoothener);
-
 		/* Stop if direction changed */
 		dir &= tracker->dir;
 		if (dir == 0) {
 			/* First movement after dirchange - velocity is that
 			 * of the last movement */
 			if (offset == 1)
-				result = velocity;
+				result = calculate_trackers_velocity(current,
+								     tracker,
+								     time,
+								     smoothener);
 			break;
 		}
 
+		velocity = calculate_trackers_velocity(current,
+						       tracker,
+						       time,
+						       smoothener);
+
 		/* Always average the first two events. On some touchpads
 		 * where the first event is jumpy, this somewhat reduces
 		 * pointer jumps on slow motions. */
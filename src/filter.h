@@ -61,6 +61,32 @@ filter_dispatch(struct motion_filter *filter,
 		const struct device_float_coords *unaccelerated,
 		void *data, uint64_t time);
 
+/**
+ * Accelerate a sequence of deltas.
+ *
+ * The result is identical to calling filter_dispatch() for each delta in
+ * order, but avoids the per-event dispatch and lets the filter process
+ * the stateless parts of the pipeline in tight loops.
+ *
+ * @param filter The device's motion filter
+ * @param unaccelerated The unaccelerated deltas in the device's dpi
+ * resolution, see filter_dispatch()
+ * @param times The timestamps of the deltas, in ascending order
+ * @param accelerated Filled with the accelerated deltas in normalized
+ * coordinates, must have space for nevents elements
+ * @param nevents The number of deltas
+ * @param data Custom data
+ *
+ * @see filter_dispatch
+ */
+void
+filter_dispatch_batch(struct motion_filter *filter,
+		      const struct device_float_coords *unaccelerated,
+		      const uint64_t *times,
+		      struct normalized_coords *accelerated,
+		      size_t nevents,
+		      void *data);
+
 /**
  * Apply constant motion filters, but no acceleration.
  *
@@ -98,6 +124,19 @@ filter_get_speed(struct motion_filter *filter);
 bool
 filter_set_curve_point(struct motion_filter *filter, double a, double fa);
 
+bool
+filter_set_curve(struct motion_filter *filter,
+		 const double *a,
+		 const double *fa,
+		 size_t npoints);
+
+bool
+filter_set_curve_interpolation(struct motion_filter *filter,
+		enum libinput_config_accel_curve_interpolation interpolation);
+
+enum libinput_config_accel_curve_interpolation
+filter_get_curve_interpolation(struct motion_filter *filter);
+
 enum libinput_config_accel_profile
 filter_get_type(struct motion_filter *filter);
 
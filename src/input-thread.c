@@ -0,0 +1,456 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "libinput-private.h"
+#include "input-thread.h"
+
+/* Must be a power of two */
+#define INPUT_THREAD_RING_SIZE 1024
+/* How long the thread waits before retrying to publish events while the
+ * caller is not draining the ring */
+#define INPUT_THREAD_RETRY_MS 1
+
+/* Single-producer, single-consumer ring. head and tail are free-running
+ * counters, head is only written by the consumer, tail only by the
+ * producer. */
+struct spsc_ring {
+	struct libinput_event *slots[INPUT_THREAD_RING_SIZE];
+	size_t head;
+	size_t tail;
+};
+
+struct input_thread {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	bool quit;
+
+	/* The caller's thread while it holds the lock through
+	 * libinput_input_thread_lock(), and how often it took it */
+	pthread_t owner;
+	unsigned int owner_depth;
+
+	/* Events are held back in the internal queue until the caller
+	 * has retrieved everything published, so they can still be
+	 * coalesced. Set by the input thread, the caller wakes it up when
+	 * it runs out of events. */
+	bool holding;
+
+	/* Negative errno once the input thread stopped on an error,
+	 * reported to the caller by libinput_dispatch() */
+	int error;
+
+	int wake_fd;	/* wakes up the input thread */
+	int event_fd;	/* readable when events were published */
+
+	/* input thread -> caller */
+	struct spsc_ring events;
+	/* caller -> input thread, events to be destroyed */
+	struct spsc_ring release;
+};
+
+static inline bool
+spsc_ring_push(struct spsc_ring *ring, struct libinput_event *event)
+{
+	size_t tail = ring->tail;
+	size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	if (tail - head == INPUT_THREAD_RING_SIZE)
+		return false;
+
+	ring->slots[tail & (INPUT_THREAD_RING_SIZE - 1)] = event;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+static inline struct libinput_event *
+spsc_ring_peek(struct spsc_ring *ring)
+{
+	size_t head = ring->head;
+	size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+	if (head == tail)
+		return NULL;
+
+	return ring->slots[head & (INPUT_THREAD_RING_SIZE - 1)];
+}
+
+/* Like spsc_ring_peek() but for the producer side, only tells whether
+ * the ring is non-empty */
+static inline bool
+spsc_ring_peek_producer(struct spsc_ring *ring)
+{
+	size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	return ring->tail != head;
+}
+
+static inline struct libinput_event *
+spsc_ring_pop(struct spsc_ring *ring)
+{
+	struct libinput_event *event;
+
+	event = spsc_ring_peek(ring);
+	if (event)
+		__atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+
+	return event;
+}
+
+static void
+eventfd_signal(int fd)
+{
+	uint64_t one = 1;
+	ssize_t rc;
+
+	do {
+		rc = write(fd, &one, sizeof(one));
+	} while (rc == -1 && errno == EINTR);
+}
+
+static void
+eventfd_clear(int fd)
+{
+	uint64_t value;
+	ssize_t rc;
+
+	do {
+		rc = read(fd, &value, sizeof(value));
+	} while (rc == -1 && errno == EINTR);
+}
+
+static void
+input_thread_drain_release(struct input_thread *thread)
+{
+	struct libinput_event *event;
+
+	while ((event = spsc_ring_pop(&thread->release)))
+		libinput_event_free(event);
+}
+
+/* Moves as many events as possible from the context's internal queue
+ * into the published ring. Returns true if any event was published.
+ *
+ * With coalescing enabled, nothing is published while the caller has
+ * not yet retrieved all published events. Events in the ring can't be
+ * merged with, so publishing them early would limit coalescing to the
+ * events of a single wakeup. */
+static bool
+input_thread_publish(struct libinput *libinput,
+		     struct input_thread *thread)
+{
+	struct libinput_event *event;
+	bool published = false;
+
+	if (libinput->event_coalescing != LIBINPUT_EVENT_COALESCE_NONE &&
+	    libinput->events_count > 0 &&
+	    spsc_ring_peek_producer(&thread->events)) {
+		__atomic_store_n(&thread->holding, true, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		/* The caller may have emptied the ring before it saw the
+		 * flag, check again so the events aren't stuck. Pairs with
+		 * the fence in input_thread_wake_if_holding(). */
+		if (spsc_ring_peek_producer(&thread->events))
+			return false;
+	}
+
+	__atomic_store_n(&thread->holding, false, __ATOMIC_RELAXED);
+
+	while (libinput->events_count > 0) {
+		event = libinput->events[libinput->events_out];
+		if (!spsc_ring_push(&thread->events, event))
+			break;
+
+		libinput_event_queue_pop(libinput);
+		published = true;
+	}
+
+	return published;
+}
+
+static void *
+input_thread_func(void *data)
+{
+	struct libinput *libinput = data;
+	struct input_thread *thread = libinput->thread;
+	struct pollfd fds[2];
+	bool backlog = false;
+	bool published;
+
+	fds[0].fd = libinput->epoll_fd;
+	fds[0].events = POLLIN;
+	fds[1].fd = thread->wake_fd;
+	fds[1].events = POLLIN;
+
+	while (!__atomic_load_n(&thread->quit, __ATOMIC_ACQUIRE)) {
+		int rc;
+
+		rc = poll(fds, ARRAY_LENGTH(fds),
+			  backlog ? INPUT_THREAD_RETRY_MS : -1);
+		if (rc == -1 && errno != EINTR) {
+			int error = -errno;
+
+			log_error(libinput,
+				  "input thread: poll failed (%s), exiting\n",
+				  strerror(-error));
+			__atomic_store_n(&thread->error, error,
+					 __ATOMIC_RELEASE);
+			eventfd_signal(thread->event_fd);
+			break;
+		}
+
+		if (rc > 0 && fds[1].revents & POLLIN)
+			eventfd_clear(thread->wake_fd);
+
+		pthread_mutex_lock(&thread->lock);
+		input_thread_drain_release(thread);
+		libinput_dispatch_sources(libinput);
+		published = input_thread_publish(libinput, thread);
+		backlog = libinput->events_count > 0 &&
+			  !__atomic_load_n(&thread->holding, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&thread->lock);
+
+		if (published)
+			eventfd_signal(thread->event_fd);
+	}
+
+	return NULL;
+}
+
+static void
+input_thread_destroy(struct input_thread *thread)
+{
+	if (thread->wake_fd != -1)
+		close(thread->wake_fd);
+	if (thread->event_fd != -1)
+		close(thread->event_fd);
+	pthread_mutex_destroy(&thread->lock);
+	free(thread);
+}
+
+LIBINPUT_EXPORT int
+libinput_input_thread_start(struct libinput *libinput)
+{
+	struct input_thread *thread;
+	pthread_mutexattr_t attr;
+	int rc;
+
+	if (libinput->thread)
+		return -EALREADY;
+
+	thread = zalloc(sizeof(*thread));
+	thread->wake_fd = -1;
+	thread->event_fd = -1;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&thread->lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	thread->wake_fd = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+	thread->event_fd = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+	if (thread->wake_fd == -1 || thread->event_fd == -1) {
+		rc = -errno;
+		input_thread_destroy(thread);
+		return rc;
+	}
+
+	/* Anything already queued is published on the first iteration */
+	libinput->thread = thread;
+	eventfd_signal(thread->wake_fd);
+
+	rc = pthread_create(&thread->thread, NULL, input_thread_func, libinput);
+	if (rc != 0) {
+		libinput->thread = NULL;
+		input_thread_destroy(thread);
+		return -rc;
+	}
+
+	return 0;
+}
+
+LIBINPUT_EXPORT void
+libinput_input_thread_stop(struct libinput *libinput)
+{
+	input_thread_stop(libinput);
+}
+
+void
+input_thread_stop(struct libinput *libinput)
+{
+	struct input_thread *thread = libinput->thread;
+	struct libinput_event *event;
+	size_t backlog;
+
+	if (!thread)
+		return;
+
+	/* The input thread may be waiting for the lock, joining it while
+	 * we hold the lock would never return */
+	if (thread->owner_depth > 0 &&
+	    pthread_equal(thread->owner, pthread_self())) {
+		log_bug_client(libinput,
+			       "input thread stopped while holding its lock\n");
+		while (thread->owner_depth > 0) {
+			thread->owner_depth--;
+			pthread_mutex_unlock(&thread->lock);
+		}
+	}
+
+	__atomic_store_n(&thread->quit, true, __ATOMIC_RELEASE);
+	eventfd_signal(thread->wake_fd);
+	pthread_join(thread->thread, NULL);
+
+	libinput->thread = NULL;
+
+	input_thread_drain_release(thread);
+
+	/* Published events go back into the internal queue, ahead of
+	 * anything the thread could not publish yet. Appending them and
+	 * rotating the backlog to the end keeps the order. */
+	backlog = libinput->events_count;
+	while ((event = spsc_ring_pop(&thread->events))) {
+		if (libinput_event_queue_push(libinput, event) != 0)
+			libinput_event_free(event);
+	}
+	while (backlog--) {
+		event = libinput_event_queue_pop(libinput);
+		libinput_event_queue_push(libinput, event);
+	}
+
+	input_thread_destroy(thread);
+}
+
+LIBINPUT_EXPORT void
+libinput_input_thread_lock(struct libinput *libinput)
+{
+	struct input_thread *thread = libinput->thread;
+
+	if (!thread)
+		return;
+
+	pthread_mutex_lock(&thread->lock);
+	if (thread->owner_depth++ == 0)
+		thread->owner = pthread_self();
+}
+
+LIBINPUT_EXPORT void
+libinput_input_thread_unlock(struct libinput *libinput)
+{
+	struct input_thread *thread = libinput->thread;
+
+	if (!thread)
+		return;
+
+	if (thread->owner_depth == 0 ||
+	    !pthread_equal(thread->owner, pthread_self())) {
+		log_bug_client(libinput,
+			       "input thread unlocked without holding its lock\n");
+		return;
+	}
+
+	thread->owner_depth--;
+	pthread_mutex_unlock(&thread->lock);
+
+	/* The caller may have queued events (e.g. by adding a device),
+	 * let the thread publish them */
+	eventfd_signal(thread->wake_fd);
+}
+
+int
+input_thread_get_fd(struct libinput *libinput)
+{
+	return libinput->thread->event_fd;
+}
+
+int
+input_thread_dispatch(struct libinput *libinput)
+{
+	eventfd_clear(libinput->thread->event_fd);
+
+	return __atomic_load_n(&libinput->thread->error, __ATOMIC_ACQUIRE);
+}
+
+/* Called by the caller once it found the ring empty */
+static void
+input_thread_wake_if_holding(struct input_thread *thread)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if (__atomic_exchange_n(&thread->holding, false, __ATOMIC_RELAXED))
+		eventfd_signal(thread->wake_fd);
+}
+
+struct libinput_event *
+input_thread_pop_event(struct libinput *libinput)
+{
+	struct libinput_event *event;
+
+	event = spsc_ring_pop(&libinput->thread->events);
+	if (!event)
+		input_thread_wake_if_holding(libinput->thread);
+
+	return event;
+}
+
+struct libinput_event *
+input_thread_peek_event(struct libinput *libinput)
+{
+	struct libinput_event *event;
+
+	event = spsc_ring_peek(&libinput->thread->events);
+	if (!event)
+		input_thread_wake_if_holding(libinput->thread);
+
+	return event;
+}
+
+bool
+input_thread_release_event(struct libinput *libinput,
+			   struct libinput_event *event)
+{
+	struct input_thread *thread = libinput->thread;
+
+	if (!thread)
+		return false;
+
+	if (!spsc_ring_push(&thread->release, event)) {
+		pthread_mutex_lock(&thread->lock);
+		libinput_event_free(event);
+		pthread_mutex_unlock(&thread->lock);
+	}
+
+	return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INPUT_THREAD_H
+#define INPUT_THREAD_H
+
+#include <stdbool.h>
+
+struct libinput;
+struct libinput_event;
+
+/* All of these are called from the caller's thread and are no-ops (or
+ * return false/NULL) while no input thread is running */
+
+void
+input_thread_stop(struct libinput *libinput);
+
+int
+input_thread_get_fd(struct libinput *libinput);
+
+int
+input_thread_dispatch(struct libinput *libinput);
+
+struct libinput_event *
+input_thread_pop_event(struct libinput *libinput);
+
+struct libinput_event *
+input_thread_peek_event(struct libinput *libinput);
+
+bool
+input_thread_release_event(struct libinput *libinput,
+			   struct libinput_event *event);
+
+#endif
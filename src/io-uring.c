@@ -0,0 +1,350 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "config.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <liburing.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "libinput-util.h"
+#include "io-uring.h"
+
+#define URING_ENTRIES 256
+
+/* Each reader keeps a POLL_ADD linked to a READ in flight: the evdev fds
+ * are non-blocking, a plain READ would complete with -EAGAIN right away.
+ * The poll half is tagged in the low bit of the user_data, only the read
+ * completion is of interest. */
+#define URING_TAG_POLL 0x1
+
+struct libinput_uring_reader {
+	struct list link;
+	int fd;
+	void *buf;
+	size_t size;
+	libinput_uring_read_func func; /* NULL once removed */
+	libinput_uring_unarmed_func unarmed;
+	void *data;
+	bool armed; /* read in flight */
+};
+
+struct uring_completion {
+	uintptr_t tag;
+	int res;
+};
+
+struct libinput_uring {
+	struct io_uring ring;
+	struct list readers;
+
+	/* Completions reaped from the ring but not processed yet */
+	struct {
+		struct uring_completion *data;
+		size_t count;
+		size_t size;
+	} pending;
+};
+
+static inline void *
+uring_poll_tag(struct libinput_uring_reader *reader)
+{
+	return (void *)((uintptr_t)reader | URING_TAG_POLL);
+}
+
+/* Moves all completions from the ring into the pending list, they are
+ * processed by the next libinput_uring_dispatch(). Returns the number
+ * of completions moved. */
+static size_t
+uring_reap(struct libinput_uring *uring)
+{
+	struct io_uring_cqe *cqe;
+	size_t count = 0;
+
+	while (io_uring_peek_cqe(&uring->ring, &cqe) == 0) {
+		struct uring_completion *completion;
+
+		if (uring->pending.count == uring->pending.size) {
+			size_t new_size = max(uring->pending.size * 2,
+					      URING_ENTRIES);
+
+			completion = realloc(uring->pending.data,
+					     new_size * sizeof(*completion));
+			if (!completion)
+				abort();
+
+			uring->pending.data = completion;
+			uring->pending.size = new_size;
+		}
+
+		completion = &uring->pending.data[uring->pending.count++];
+		completion->tag = (uintptr_t)io_uring_cqe_get_data(cqe);
+		completion->res = cqe->res;
+		io_uring_cqe_seen(&uring->ring, cqe);
+		count++;
+	}
+
+	return count;
+}
+
+/* Submits everything queued. Submission fails with -EBUSY while
+ * completions overflow the completion queue, those are reaped into the
+ * pending list until the submission goes through. */
+static int
+uring_submit(struct libinput_uring *uring)
+{
+	int rc;
+
+	do {
+		rc = io_uring_submit(&uring->ring);
+	} while (rc == -EBUSY && uring_reap(uring) > 0);
+
+	return rc < 0 ? rc : 0;
+}
+
+/* Returns the first of count consecutive sqes, or NULL if the
+ * submission queue is full and can't be submitted */
+static struct io_uring_sqe *
+uring_get_sqes(struct libinput_uring *uring, unsigned int count)
+{
+	if (io_uring_sq_space_left(&uring->ring) < count &&
+	    (uring_submit(uring) < 0 ||
+	     io_uring_sq_space_left(&uring->ring) < count))
+		return NULL;
+
+	return io_uring_get_sqe(&uring->ring);
+}
+
+static int
+uring_arm(struct libinput_uring *uring,
+	  struct libinput_uring_reader *reader)
+{
+	struct io_uring_sqe *sqe;
+
+	sqe = uring_get_sqes(uring, 2);
+	if (!sqe)
+		return -EBUSY;
+
+	io_uring_prep_poll_add(sqe, reader->fd, POLLIN);
+	io_uring_sqe_set_flags(sqe, IOSQE_IO_LINK);
+	io_uring_sqe_set_data(sqe, uring_poll_tag(reader));
+
+	/* can't fail, uring_get_sqes() checked for space */
+	sqe = io_uring_get_sqe(&uring->ring);
+	assert(sqe);
+	io_uring_prep_read(sqe, reader->fd, reader->buf, reader->size, -1);
+	io_uring_sqe_set_data(sqe, reader);
+
+	reader->armed = true;
+
+	return 0;
+}
+
+static void
+uring_reader_free(struct libinput_uring_reader *reader)
+{
+	list_remove(&reader->link);
+	free(reader->buf);
+	free(reader);
+}
+
+struct libinput_uring *
+libinput_uring_create(void)
+{
+	struct libinput_uring *uring;
+	struct io_uring_probe *probe;
+	bool supported;
+
+	uring = zalloc(sizeof *uring);
+	if (io_uring_queue_init(URING_ENTRIES, &uring->ring, 0) < 0) {
+		free(uring);
+		return NULL;
+	}
+
+	/* IORING_OP_READ needs 5.6, older kernels have the ring but not
+	 * the opcode */
+	probe = io_uring_get_probe_ring(&uring->ring);
+	supported = probe &&
+		    io_uring_opcode_supported(probe, IORING_OP_POLL_ADD) &&
+		    io_uring_opcode_supported(probe, IORING_OP_READ) &&
+		    io_uring_opcode_supported(probe, IORING_OP_ASYNC_CANCEL);
+	if (probe)
+		io_uring_free_probe(probe);
+
+	if (!supported) {
+		io_uring_queue_exit(&uring->ring);
+		free(uring);
+		return NULL;
+	}
+
+	list_init(&uring->readers);
+
+	return uring;
+}
+
+void
+libinput_uring_destroy(struct libinput_uring *uring)
+{
+	struct libinput_uring_reader *reader, *tmp;
+
+	if (!uring)
+		return;
+
+	/* cancels everything still in flight */
+	io_uring_queue_exit(&uring->ring);
+
+	list_for_each_safe(reader, tmp, &uring->readers, link)
+		uring_reader_free(reader);
+
+	free(uring->pending.data);
+	free(uring);
+}
+
+int
+libinput_uring_get_fd(struct libinput_uring *uring)
+{
+	return uring->ring.ring_fd;
+}
+
+static void
+uring_complete(struct libinput_uring *uring,
+	       struct libinput_uring_reader *reader,
+	       int res)
+{
+	reader->armed = false;
+
+	if (reader->func)
+		reader->func(reader->data, reader->buf, res);
+
+	/* may have been removed from within func */
+	if (!reader->func) {
+		uring_reader_free(reader);
+		return;
+	}
+
+	if (uring_arm(uring, reader) != 0) {
+		libinput_uring_unarmed_func unarmed = reader->unarmed;
+		void *reader_data = reader->data;
+
+		uring_reader_free(reader);
+		unarmed(reader_data);
+	}
+}
+
+void
+libinput_uring_dispatch(void *data)
+{
+	struct libinput_uring *uring = data;
+	struct uring_completion *completion;
+	size_t i;
+
+	uring_reap(uring);
+
+	/* Re-arming or removing a reader may reap more completions into
+	 * the list, so it's walked by index */
+	for (i = 0; i < uring->pending.count; i++) {
+		completion = &uring->pending.data[i];
+
+		/* cancel requests and the poll half of a link, if the poll
+		 * fails the linked read completes with -ECANCELED */
+		if (completion->tag == 0 || (completion->tag & URING_TAG_POLL))
+			continue;
+
+		uring_complete(uring,
+			       (struct libinput_uring_reader *)completion->tag,
+			       completion->res);
+	}
+	uring->pending.count = 0;
+
+	/* One submission re-arms all readers. A failure other than
+	 * -EBUSY leaves the requests queued for the next submission. */
+	uring_submit(uring);
+}
+
+struct libinput_uring_reader *
+libinput_uring_add_reader(struct libinput_uring *uring,
+			  int fd,
+			  size_t size,
+			  libinput_uring_read_func func,
+			  libinput_uring_unarmed_func unarmed,
+			  void *data)
+{
+	struct libinput_uring_reader *reader;
+
+	assert(func);
+	assert(unarmed);
+
+	reader = zalloc(sizeof *reader);
+	reader->fd = fd;
+	reader->buf = zalloc(size);
+	reader->size = size;
+	reader->func = func;
+	reader->unarmed = unarmed;
+	reader->data = data;
+	list_insert(&uring->readers, &reader->link);
+
+	if (uring_arm(uring, reader) != 0) {
+		uring_reader_free(reader);
+		return NULL;
+	}
+
+	uring_submit(uring);
+
+	return reader;
+}
+
+void
+libinput_uring_remove_reader(struct libinput_uring *uring,
+			     struct libinput_uring_reader *reader)
+{
+	struct io_uring_sqe *sqe;
+
+	reader->func = NULL;
+	reader->data = NULL;
+
+	/* Removed from within its callback, the dispatch loop frees it */
+	if (!reader->armed)
+		return;
+
+	/* Cancelling the poll cancels the linked read. The read must be
+	 * submitted before the caller closes the fd: the kernel resolves
+	 * the fd on submission, a read still queued would otherwise hit
+	 * whatever file reuses the fd. Once submitted, the ring holds its
+	 * own reference to the file until the read completes. */
+	sqe = uring_get_sqes(uring, 1);
+	if (sqe) {
+		io_uring_prep_cancel(sqe, uring_poll_tag(reader), 0);
+		io_uring_sqe_set_data(sqe, NULL);
+	}
+
+	/* uring_submit() reaps completions until the submission goes
+	 * through, the only failures left are hard errors of the ring
+	 * itself. Without a cancel sqe, the submitted read stays in
+	 * flight on the old file until it becomes readable or the device
+	 * goes away, the dispatch loop frees the reader then. */
+	uring_submit(uring);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+struct libinput_uring;
+struct libinput_uring_reader;
+
+/* len is the number of bytes read into buf or a negative errno */
+typedef void (*libinput_uring_read_func)(void *data, void *buf, ssize_t len);
+/* The reader's read could not be re-armed, e.g. because the ring is
+ * overloaded. The reader is freed, the fd must be watched by other
+ * means from now on. */
+typedef void (*libinput_uring_unarmed_func)(void *data);
+
+#if HAVE_LIBURING
+
+/* Returns NULL if io_uring is not available on this kernel */
+struct libinput_uring *
+libinput_uring_create(void);
+
+void
+libinput_uring_destroy(struct libinput_uring *uring);
+
+int
+libinput_uring_get_fd(struct libinput_uring *uring);
+
+/* Drains all completions, call when the ring fd is readable */
+void
+libinput_uring_dispatch(void *data);
+
+/* Keeps a read of up to size bytes outstanding on fd, func is called
+ * with the data for each completed read. Returns NULL if the read can't
+ * be issued. */
+struct libinput_uring_reader *
+libinput_uring_add_reader(struct libinput_uring *uring,
+			  int fd,
+			  size_t size,
+			  libinput_uring_read_func func,
+			  libinput_uring_unarmed_func unarmed,
+			  void *data);
+
+/* func is not called after this, the reader is freed once its
+ * outstanding read is cancelled. The read is submitted to the kernel
+ * before this returns, the caller may close the fd afterwards. */
+void
+libinput_uring_remove_reader(struct libinput_uring *uring,
+			     struct libinput_uring_reader *reader);
+
+#else
+
+static inline struct libinput_uring *
+libinput_uring_create(void)
+{
+	return NULL;
+}
+
+static inline void
+libinput_uring_destroy(struct libinput_uring *uring)
+{
+}
+
+static inline int
+libinput_uring_get_fd(struct libinput_uring *uring)
+{
+	return -1;
+}
+
+static inline void
+libinput_uring_dispatch(void *data)
+{
+}
+
+static inline struct libinput_uring_reader *
+libinput_uring_add_reader(struct libinput_uring *uring,
+			  int fd,
+			  size_t size,
+			  libinput_uring_read_func func,
+			  libinput_uring_unarmed_func unarmed,
+			  void *data)
+{
+	return NULL;
+}
+
+static inline void
+libinput_uring_remove_reader(struct libinput_uring *uring,
+			     struct libinput_uring_reader *reader)
+{
+}
+
+#endif
+
+#endif
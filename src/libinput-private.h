@@ -44,6 +44,9 @@
 #endif
 
 struct libinput_source;
+struct libinput_uring;
+struct input_thread;
+struct trace_record;
 
 /* A coordinate pair in device coordinates */
 struct device_coords {
@@ -100,12 +103,64 @@ struct wheel_tilt_flags {
 	bool vertical, horizontal;
 };
 
+/* Destroyed events are recycled through per-context free lists, one list
+ * per size class. Every event struct fits into one of the size classes */
+#define EVENT_POOL_CLASS_SIZE 64
+#define EVENT_POOL_NCLASSES 4
+#define EVENT_POOL_DEFAULT_LIMIT 256
+
+/* The event queue size is always a power of two */
+#define EVENT_QUEUE_DEFAULT_SIZE 4
+#define EVENT_QUEUE_MAX_SIZE (1 << 20)
+
+struct event_pool_entry;
+
+/* Inline event storage: events are stored by value in slots sized for
+ * the largest event struct, packed into contiguous slabs. Slabs are
+ * aligned to their size so a slot's slab can be found from its address,
+ * the first slot of each slab holds the slab header. */
+#define EVENT_SLOT_SIZE (EVENT_POOL_CLASS_SIZE * EVENT_POOL_NCLASSES)
+#define EVENT_SLAB_SIZE (64 * EVENT_SLOT_SIZE)
+
+/* Latency histograms, bucket n counts latencies in [2^(n-1), 2^n) us,
+ * bucket 0 counts latencies below 1us, the last bucket everything above */
+#define LATENCY_NBUCKETS 20
+#define LATENCY_NSTAGES (LIBINPUT_LATENCY_STAGE_TOTAL + 1)
+#define LATENCY_NEVENT_TYPES 26
+
+struct latency_stats {
+	uint64_t buckets[LATENCY_NEVENT_TYPES][LATENCY_NSTAGES][LATENCY_NBUCKETS];
+};
+
 struct libinput_interface_backend {
 	int (*resume)(struct libinput *libinput);
 	void (*suspend)(struct libinput *libinput);
 	void (*destroy)(struct libinput *libinput);
 	int (*device_change_seat)(struct libinput_device *device,
 				  const char *seat_name);
+	/* true if the backend supports libinput_interface_async */
+	bool async_open;
+	/* true if the backend supports LIBINPUT_SUSPEND_KEEP_DEVICES */
+	bool keep_devices;
+};
+
+typedef void (*libinput_open_done_func)(struct libinput *libinput,
+					struct udev_device *udev_device,
+					const char *seat_name,
+					int fd);
+
+struct libinput_open_request {
+	struct list link;
+	struct libinput *libinput; /* NULL once cancelled */
+	char *path;
+	struct udev_device *udev_device;
+	char *seat_name;
+	libinput_open_done_func done;
+
+	/* copied so a cancelled request can close its fd even after the
+	 * context is gone */
+	void (*close_restricted)(int fd, void *user_data);
+	void *user_data;
 };
 
 struct libinput {
@@ -115,7 +170,10 @@ struct libinput {
 	struct list seat_list;
 
 	struct {
-		struct list list;
+		/* binary min-heap of armed timers, ordered by expiry */
+		struct libinput_timer **heap;
+		size_t heap_count;
+		size_t heap_size;
 		struct libinput_source *source;
 		int fd;
 		uint64_t next_expiry;
@@ -123,14 +181,56 @@ struct libinput {
 
 	struct libinput_event **events;
 	size_t events_count;
-	size_t events_len;
+	size_t events_len; /* always a power of two */
 	size_t events_in;
 	size_t events_out;
+	uint32_t event_coalescing; /* enum libinput_event_coalescing */
+	uint32_t event_mask; /* EVENT_TYPE_MASK() bits of suppressed types */
+
+	struct {
+		struct event_pool_entry *free_list[EVENT_POOL_NCLASSES];
+		unsigned int count; /* number of events on the free lists */
+		unsigned int limit; /* high-water mark for count */
+		uint64_t hits;
+		uint64_t misses;
+	} event_pool;
+
+	struct {
+		enum libinput_event_storage storage;
+		struct list list; /* slabs with free slots first */
+		unsigned int count;
+	} event_slabs;
+
+	struct {
+		struct trace_record *records; /* NULL if tracing is disabled */
+		unsigned int size; /* power of two */
+		uint64_t count; /* total number of records written */
+		unsigned int last_device_id;
+	} trace;
+
+	struct {
+		bool enabled;
+		uint64_t dispatch_time; /* start of the current source dispatch */
+		struct latency_stats *stats; /* context-wide */
+	} latency;
 
 	struct list tool_list;
 
+	struct input_thread *thread; /* NULL unless an input thread runs */
+
 	const struct libinput_interface *interface;
 	const struct libinput_interface_backend *interface_backend;
+	const struct libinput_interface_async *interface_async;
+	struct list open_requests; /* pending libinput_open_request */
+	enum libinput_suspend_mode suspend_mode;
+
+	struct {
+		enum libinput_read_backend backend;
+		/* created on the first switch to io_uring, kept until
+		 * the context is destroyed */
+		struct libinput_uring *uring;
+		struct libinput_source *source;
+	} read;
 
 	libinput_log_handler log_handler;
 	enum libinput_log_priority log_priority;
@@ -215,6 +315,15 @@ struct libinput_device_config_accel {
 	enum libinput_config_accel_profile (*get_default_profile)(struct libinput_device *device);
 	enum libinput_config_status (*set_curve_point)(struct libinput_device *device,
 						       double a, double fa);
+	enum libinput_config_status (*set_curve)(struct libinput_device *device,
+						 const double *a,
+						 const double *fa,
+						 size_t npoints);
+	enum libinput_config_status (*set_curve_interpolation)(
+			struct libinput_device *device,
+			enum libinput_config_accel_curve_interpolation interpolation);
+	enum libinput_config_accel_curve_interpolation (*get_curve_interpolation)(
+			struct libinput_device *device);
 };
 
 struct libinput_device_config_natural_scroll {
@@ -310,9 +419,13 @@ struct libinput_device {
 	struct libinput_device_group *group;
 	struct list link;
 	struct list event_listeners;
+	uint32_t event_listener_types; /* union of all listener types */
+	uint32_t event_mask; /* EVENT_TYPE_MASK() bits of suppressed types */
 	void *user_data;
 	int refcount;
 	struct libinput_device_config config;
+	struct latency_stats *latency;
+	unsigned int trace_id; /* identifies the device in trace records */
 };
 
 enum libinput_tablet_tool_axis {
@@ -379,16 +492,67 @@ struct libinput_tablet_pad_mode_group {
 struct libinput_event {
 	enum libinput_event_type type;
 	struct libinput_device *device;
+	bool inline_storage; /* a slot in one of the event slabs */
+
+	/* only set if latency tracking is enabled */
+	uint64_t dispatch_time;
+	uint64_t queued_time;
 };
 
+/* A dense index for each event type, used for per-type tables and
+ * masks. Returns -1 for LIBINPUT_EVENT_NONE. */
+static inline int
+event_type_index(enum libinput_event_type type)
+{
+	switch (type) {
+	case LIBINPUT_EVENT_NONE:
+		break;
+	case LIBINPUT_EVENT_DEVICE_ADDED:		return 0;
+	case LIBINPUT_EVENT_DEVICE_REMOVED:		return 1;
+	case LIBINPUT_EVENT_KEYBOARD_KEY:		return 2;
+	case LIBINPUT_EVENT_POINTER_MOTION:		return 3;
+	case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:	return 4;
+	case LIBINPUT_EVENT_POINTER_BUTTON:		return 5;
+	case LIBINPUT_EVENT_POINTER_AXIS:		return 6;
+	case LIBINPUT_EVENT_TOUCH_DOWN:			return 7;
+	case LIBINPUT_EVENT_TOUCH_UP:			return 8;
+	case LIBINPUT_EVENT_TOUCH_MOTION:		return 9;
+	case LIBINPUT_EVENT_TOUCH_CANCEL:		return 10;
+	case LIBINPUT_EVENT_TOUCH_FRAME:		return 11;
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS:		return 12;
+	case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:	return 13;
+	case LIBINPUT_EVENT_TABLET_TOOL_TIP:		return 14;
+	case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:		return 15;
+	case LIBINPUT_EVENT_TABLET_PAD_BUTTON:		return 16;
+	case LIBINPUT_EVENT_TABLET_PAD_RING:		return 17;
+	case LIBINPUT_EVENT_TABLET_PAD_STRIP:		return 18;
+	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:	return 19;
+	case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:	return 20;
+	case LIBINPUT_EVENT_GESTURE_SWIPE_END:		return 21;
+	case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:	return 22;
+	case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:	return 23;
+	case LIBINPUT_EVENT_GESTURE_PINCH_END:		return 24;
+	case LIBINPUT_EVENT_SWITCH_TOGGLE:		return 25;
+	}
+
+	return -1;
+}
+
+#define EVENT_TYPE_MASK(type_) (1U << event_type_index(type_))
+
 struct libinput_event_listener {
 	struct list link;
+	struct libinput_device *device;
+	uint32_t types; /* mask of EVENT_TYPE_MASK() bits */
 	void (*notify_func)(uint64_t time, struct libinput_event *ev, void *notify_func_data);
 	void *notify_func_data;
 };
 
 typedef void (*libinput_source_dispatch_t)(void *data);
 
+/* len is the number of bytes in buf or a negative errno */
+typedef void (*libinput_source_read_t)(void *data, void *buf, ssize_t len);
+
 #define log_debug(li_, ...) log_msg((li_), LIBINPUT_LOG_PRIORITY_DEBUG, __VA_ARGS__)
 #define log_info(li_, ...) log_msg((li_), LIBINPUT_LOG_PRIORITY_INFO, __VA_ARGS__)
 #define log_error(li_, ...) log_msg((li_), LIBINPUT_LOG_PRIORITY_ERROR, __VA_ARGS__)
@@ -435,10 +599,36 @@ libinput_add_fd(struct libinput *libinput,
 		libinput_source_dispatch_t dispatch,
 		void *data);
 
+/* With the io_uring read backend, read is called with up to size bytes
+ * read from fd, or with a negative errno and possibly a NULL buf on
+ * failure. Otherwise this is libinput_add_fd() and dispatch is called
+ * when fd is readable. If the io_uring read can't be issued, the source
+ * falls back to epoll and dispatch. */
+struct libinput_source *
+libinput_add_fd_reader(struct libinput *libinput,
+		       int fd,
+		       size_t size,
+		       libinput_source_dispatch_t dispatch,
+		       libinput_source_read_t read,
+		       void *data);
+
 void
 libinput_remove_source(struct libinput *libinput,
 		       struct libinput_source *source);
 
+int
+libinput_dispatch_sources(struct libinput *libinput);
+
+int
+libinput_event_queue_push(struct libinput *libinput,
+			  struct libinput_event *event);
+
+struct libinput_event *
+libinput_event_queue_pop(struct libinput *libinput);
+
+void
+libinput_event_free(struct libinput_event *event);
+
 int
 open_restricted(struct libinput *libinput,
 		const char *path, int flags);
@@ -446,6 +636,23 @@ open_restricted(struct libinput *libinput,
 void
 close_restricted(struct libinput *libinput, int fd);
 
+static inline bool
+libinput_open_is_async(struct libinput *libinput)
+{
+	return libinput->interface_async != NULL;
+}
+
+void
+libinput_open_async(struct libinput *libinput,
+		    struct udev_device *udev_device,
+		    const char *seat_name,
+		    int flags,
+		    libinput_open_done_func done);
+
+void
+libinput_open_requests_cancel(struct libinput *libinput,
+			      const char *syspath);
+
 bool
 ignore_litest_test_suite_device(struct udev_device *device);
 
@@ -478,6 +685,7 @@ libinput_device_init_event_listener(struct libinput_event_listener *listener);
 void
 libinput_device_add_event_listener(struct libinput_device *device,
 				   struct libinput_event_listener *listener,
+				   uint32_t types,
 				   void (*notify_func)(
 						uint64_t time,
 						struct libinput_event *event,
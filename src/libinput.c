@@ -37,7 +37,10 @@
 #include "libinput.h"
 #include "libinput-private.h"
 #include "evdev.h"
+#include "input-thread.h"
+#include "io-uring.h"
 #include "timer.h"
+#include "trace.h"
 
 #define require_event_type(li_, type_, retval_, ...)	\
 	if (type_ == LIBINPUT_EVENT_NONE) abort(); \
@@ -74,6 +77,11 @@ ASSERT_INT_SIZE(enum libinput_config_click_method);
 ASSERT_INT_SIZE(enum libinput_config_middle_emulation_state);
 ASSERT_INT_SIZE(enum libinput_config_scroll_method);
 ASSERT_INT_SIZE(enum libinput_config_dwt_state);
+ASSERT_INT_SIZE(enum libinput_config_accel_curve_interpolation);
+ASSERT_INT_SIZE(enum libinput_latency_stage);
+ASSERT_INT_SIZE(enum libinput_event_storage);
+ASSERT_INT_SIZE(enum libinput_suspend_mode);
+ASSERT_INT_SIZE(enum libinput_read_backend);
 
 static inline bool
 check_event_type(struct libinput *libinput,
@@ -147,6 +155,9 @@ struct libinput_source {
 	libinput_source_dispatch_t dispatch;
 	void *user_data;
 	int fd;
+	struct libinput_uring_reader *reader; /* instead of epoll if set */
+	libinput_source_read_t read; /* with reader only */
+	struct libinput *libinput; /* with reader only */
 	struct list link;
 };
 
@@ -236,6 +247,36 @@ struct libinput_event_switch {
 	enum libinput_switch_state state;
 };
 
+struct event_pool_entry {
+	struct event_pool_entry *next;
+};
+
+struct event_slab {
+	struct list link;
+	struct event_pool_entry *free_list;
+	unsigned int nfree;
+	unsigned int nfresh; /* slots from here on were never used */
+};
+
+#define EVENT_SLAB_NSLOTS (EVENT_SLAB_SIZE / EVENT_SLOT_SIZE - 1)
+
+static_assert(sizeof(struct event_slab) <= EVENT_SLOT_SIZE,
+	      "slab header exceeds a slot");
+
+#define ASSERT_EVENT_POOL_SIZE(type_) \
+	static_assert(sizeof(type_) <= \
+		      EVENT_POOL_CLASS_SIZE * EVENT_POOL_NCLASSES, \
+		      "sizeof(" #type_ ") exceeds the event pool size classes")
+
+ASSERT_EVENT_POOL_SIZE(struct libinput_event_device_notify);
+ASSERT_EVENT_POOL_SIZE(struct libinput_event_keyboard);
+ASSERT_EVENT_POOL_SIZE(struct libinput_event_pointer);
+ASSERT_EVENT_POOL_SIZE(struct libinput_event_touch);
+ASSERT_EVENT_POOL_SIZE(struct libinput_event_gesture);
+ASSERT_EVENT_POOL_SIZE(struct libinput_event_tablet_tool);
+ASSERT_EVENT_POOL_SIZE(struct libinput_event_tablet_pad);
+ASSERT_EVENT_POOL_SIZE(struct libinput_event_switch);
+
 LIBINPUT_ATTRIBUTE_PRINTF(3, 0)
 static void
 libinput_default_log_func(struct libinput *libinput,
@@ -1665,15 +1706,413 @@ libinput_add_fd(struct libinput *libinput,
 	return source;
 }
 
+static void
+libinput_source_read(void *data, void *buf, ssize_t len)
+{
+	struct libinput_source *source = data;
+
+	source->read(source->user_data, buf, len);
+}
+
+/* The io_uring reader can't be re-armed, watch the fd with epoll and let
+ * the dispatch function do the reads from now on */
+static void
+libinput_source_unarmed(void *data)
+{
+	struct libinput_source *source = data;
+	struct libinput *libinput = source->libinput;
+	struct epoll_event ep;
+
+	source->reader = NULL;
+
+	log_error(libinput,
+		  "io_uring read failed to re-arm, falling back to epoll\n");
+
+	memset(&ep, 0, sizeof ep);
+	ep.events = EPOLLIN;
+	ep.data.ptr = source;
+
+	if (epoll_ctl(libinput->epoll_fd, EPOLL_CTL_ADD, source->fd, &ep) < 0)
+		source->read(source->user_data, NULL, -errno);
+}
+
+struct libinput_source *
+libinput_add_fd_reader(struct libinput *libinput,
+		       int fd,
+		       size_t size,
+		       libinput_source_dispatch_t dispatch,
+		       libinput_source_read_t read,
+		       void *user_data)
+{
+	struct libinput_source *source;
+
+	if (libinput->read.backend != LIBINPUT_READ_BACKEND_IO_URING)
+		return libinput_add_fd(libinput, fd, dispatch, user_data);
+
+	source = zalloc(sizeof *source);
+	source->dispatch = dispatch;
+	source->user_data = user_data;
+	source->fd = fd;
+	source->read = read;
+	source->libinput = libinput;
+	source->reader = libinput_uring_add_reader(libinput->read.uring,
+						   fd,
+						   size,
+						   libinput_source_read,
+						   libinput_source_unarmed,
+						   source);
+	if (!source->reader) {
+		free(source);
+		return libinput_add_fd(libinput, fd, dispatch, user_data);
+	}
+
+	return source;
+}
+
 void
 libinput_remove_source(struct libinput *libinput,
 		       struct libinput_source *source)
 {
-	epoll_ctl(libinput->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+	if (source->reader) {
+		libinput_uring_remove_reader(libinput->read.uring,
+					     source->reader);
+		source->reader = NULL;
+	} else {
+		epoll_ctl(libinput->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+	}
 	source->fd = -1;
 	list_insert(&libinput->source_destroy_list, &source->link);
 }
 
+static inline size_t
+event_pool_class(size_t size)
+{
+	assert(size > 0);
+	assert(size <= EVENT_POOL_CLASS_SIZE * EVENT_POOL_NCLASSES);
+
+	return (size - 1) / EVENT_POOL_CLASS_SIZE;
+}
+
+static size_t
+event_size(enum libinput_event_type type)
+{
+	switch (type) {
+	case LIBINPUT_EVENT_NONE:
+		abort();
+	case LIBINPUT_EVENT_DEVICE_ADDED:
+	case LIBINPUT_EVENT_DEVICE_REMOVED:
+		return sizeof(struct libinput_event_device_notify);
+	case LIBINPUT_EVENT_KEYBOARD_KEY:
+		return sizeof(struct libinput_event_keyboard);
+	case LIBINPUT_EVENT_POINTER_MOTION:
+	case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
+	case LIBINPUT_EVENT_POINTER_BUTTON:
+	case LIBINPUT_EVENT_POINTER_AXIS:
+		return sizeof(struct libinput_event_pointer);
+	case LIBINPUT_EVENT_TOUCH_DOWN:
+	case LIBINPUT_EVENT_TOUCH_UP:
+	case LIBINPUT_EVENT_TOUCH_MOTION:
+	case LIBINPUT_EVENT_TOUCH_CANCEL:
+	case LIBINPUT_EVENT_TOUCH_FRAME:
+		return sizeof(struct libinput_event_touch);
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
+	case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
+	case LIBINPUT_EVENT_TABLET_TOOL_TIP:
+	case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:
+		return sizeof(struct libinput_event_tablet_tool);
+	case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
+	case LIBINPUT_EVENT_TABLET_PAD_RING:
+	case LIBINPUT_EVENT_TABLET_PAD_STRIP:
+		return sizeof(struct libinput_event_tablet_pad);
+	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+	case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_PINCH_END:
+		return sizeof(struct libinput_event_gesture);
+	case LIBINPUT_EVENT_SWITCH_TOGGLE:
+		return sizeof(struct libinput_event_switch);
+	}
+
+	abort();
+}
+
+/* The kernel timestamp of the event, or 0 if the event has none */
+static uint64_t
+event_get_time(struct libinput_event *event)
+{
+	switch (event->type) {
+	case LIBINPUT_EVENT_NONE:
+	case LIBINPUT_EVENT_DEVICE_ADDED:
+	case LIBINPUT_EVENT_DEVICE_REMOVED:
+		break;
+	case LIBINPUT_EVENT_KEYBOARD_KEY:
+		return ((struct libinput_event_keyboard *)event)->time;
+	case LIBINPUT_EVENT_POINTER_MOTION:
+	case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
+	case LIBINPUT_EVENT_POINTER_BUTTON:
+	case LIBINPUT_EVENT_POINTER_AXIS:
+		return ((struct libinput_event_pointer *)event)->time;
+	case LIBINPUT_EVENT_TOUCH_DOWN:
+	case LIBINPUT_EVENT_TOUCH_UP:
+	case LIBINPUT_EVENT_TOUCH_MOTION:
+	case LIBINPUT_EVENT_TOUCH_CANCEL:
+	case LIBINPUT_EVENT_TOUCH_FRAME:
+		return ((struct libinput_event_touch *)event)->time;
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
+	case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
+	case LIBINPUT_EVENT_TABLET_TOOL_TIP:
+	case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:
+		return ((struct libinput_event_tablet_tool *)event)->time;
+	case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
+	case LIBINPUT_EVENT_TABLET_PAD_RING:
+	case LIBINPUT_EVENT_TABLET_PAD_STRIP:
+		return ((struct libinput_event_tablet_pad *)event)->time;
+	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+	case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_PINCH_END:
+		return ((struct libinput_event_gesture *)event)->time;
+	case LIBINPUT_EVENT_SWITCH_TOGGLE:
+		return ((struct libinput_event_switch *)event)->time;
+	}
+
+	return 0;
+}
+
+static inline void
+latency_stats_add(struct latency_stats *stats,
+		  int type_index,
+		  enum libinput_latency_stage stage,
+		  uint64_t start,
+		  uint64_t end)
+{
+	uint64_t us = end > start ? end - start : 0;
+	unsigned int bucket = 0;
+
+	if (us > 0)
+		bucket = min(64 - __builtin_clzll(us), LATENCY_NBUCKETS - 1);
+
+	stats->buckets[type_index][stage][bucket]++;
+}
+
+static void
+latency_stats_record(struct latency_stats *stats,
+		     struct libinput_event *event,
+		     uint64_t kernel_time,
+		     uint64_t now)
+{
+	int idx = event_type_index(event->type);
+
+	assert(idx >= 0 && idx < LATENCY_NEVENT_TYPES);
+
+	if (kernel_time && event->dispatch_time)
+		latency_stats_add(stats, idx, LIBINPUT_LATENCY_STAGE_KERNEL,
+				  kernel_time, event->dispatch_time);
+	if (event->dispatch_time)
+		latency_stats_add(stats, idx, LIBINPUT_LATENCY_STAGE_PROCESS,
+				  event->dispatch_time, event->queued_time);
+	latency_stats_add(stats, idx, LIBINPUT_LATENCY_STAGE_QUEUE,
+			  event->queued_time, now);
+	if (kernel_time)
+		latency_stats_add(stats, idx, LIBINPUT_LATENCY_STAGE_TOTAL,
+				  kernel_time, now);
+}
+
+/* Called when the caller retrieves the event from the queue */
+static void
+latency_track_retrieved(struct libinput *libinput,
+			struct libinput_event *event)
+{
+	struct libinput_device *device = event->device;
+	uint64_t now, kernel_time;
+
+	if (!libinput->latency.enabled || event->queued_time == 0)
+		return;
+
+	now = libinput_now(libinput);
+	kernel_time = event_get_time(event);
+
+	latency_stats_record(libinput->latency.stats, event, kernel_time, now);
+
+	if (device && device->latency)
+		latency_stats_record(device->latency, event, kernel_time, now);
+}
+
+static inline void *
+event_slab_slot(struct event_slab *slab, unsigned int idx)
+{
+	return (char *)slab + (idx + 1) * EVENT_SLOT_SIZE;
+}
+
+static void *
+event_slab_alloc(struct libinput *libinput)
+{
+	struct event_slab *slab = NULL;
+	struct event_pool_entry *entry;
+	void *slot;
+
+	if (!list_empty(&libinput->event_slabs.list))
+		slab = list_first_entry(&libinput->event_slabs.list,
+					slab,
+					link);
+
+	if (!slab || slab->nfree == 0) {
+		if (posix_memalign((void **)&slab,
+				   EVENT_SLAB_SIZE,
+				   EVENT_SLAB_SIZE) != 0)
+			abort();
+
+		memset(slab, 0, sizeof(*slab));
+		slab->nfree = EVENT_SLAB_NSLOTS;
+		list_insert(&libinput->event_slabs.list, &slab->link);
+		libinput->event_slabs.count++;
+	}
+
+	if (slab->free_list) {
+		entry = slab->free_list;
+		slab->free_list = entry->next;
+		slot = entry;
+	} else {
+		slot = event_slab_slot(slab, slab->nfresh++);
+	}
+
+	/* Full slabs go to the back of the list */
+	if (--slab->nfree == 0) {
+		list_remove(&slab->link);
+		list_insert(libinput->event_slabs.list.prev, &slab->link);
+	}
+
+	memset(slot, 0, EVENT_SLOT_SIZE);
+
+	return slot;
+}
+
+/* Slabs are aligned to their size, the slab header is at the start of
+ * the slab the slot is in */
+static inline struct event_slab *
+event_slab_from_slot(void *slot)
+{
+	return (struct event_slab *)((uintptr_t)slot &
+				     ~((uintptr_t)EVENT_SLAB_SIZE - 1));
+}
+
+static void
+event_slab_release(struct libinput *libinput, void *event)
+{
+	struct event_pool_entry *entry = event;
+	struct event_slab *slab = event_slab_from_slot(event);
+
+	entry->next = slab->free_list;
+	slab->free_list = entry;
+	slab->nfree++;
+
+	/* Keep one empty slab around, free any others */
+	list_remove(&slab->link);
+	if (slab->nfree == EVENT_SLAB_NSLOTS &&
+	    libinput->event_slabs.count > 1) {
+		libinput->event_slabs.count--;
+		free(slab);
+	} else {
+		list_insert(&libinput->event_slabs.list, &slab->link);
+	}
+}
+
+static void
+event_slab_destroy_all(struct libinput *libinput)
+{
+	struct event_slab *slab, *tmp;
+
+	list_for_each_safe(slab, tmp, &libinput->event_slabs.list, link) {
+		list_remove(&slab->link);
+		free(slab);
+	}
+	libinput->event_slabs.count = 0;
+}
+
+/**
+ * Allocate a zeroed event of the given size. The memory is always the
+ * full size of the size class so it can be reused for any other event
+ * struct in the same class. With inline storage, the event is a slot in
+ * one of the slabs instead.
+ */
+static void *
+event_pool_alloc(struct libinput *libinput, size_t size)
+{
+	struct event_pool_entry *entry;
+	size_t class = event_pool_class(size);
+	size_t class_size = (class + 1) * EVENT_POOL_CLASS_SIZE;
+
+	if (libinput->event_slabs.storage == LIBINPUT_EVENT_STORAGE_INLINE)
+		return event_slab_alloc(libinput);
+
+	entry = libinput->event_pool.free_list[class];
+	if (!entry) {
+		libinput->event_pool.misses++;
+		return zalloc(class_size);
+	}
+
+	libinput->event_pool.free_list[class] = entry->next;
+	libinput->event_pool.count--;
+	libinput->event_pool.hits++;
+
+	memset(entry, 0, class_size);
+
+	return entry;
+}
+
+static void
+event_pool_release(struct libinput *libinput, void *event, size_t size)
+{
+	struct event_pool_entry *entry = event;
+	size_t class = event_pool_class(size);
+
+	/* Events keep the storage they were allocated from, even if the
+	 * storage mode changed since */
+	if (((struct libinput_event *)event)->inline_storage) {
+		event_slab_release(libinput, event);
+		return;
+	}
+
+	if (libinput->event_pool.count >= libinput->event_pool.limit) {
+		free(event);
+		return;
+	}
+
+	entry->next = libinput->event_pool.free_list[class];
+	libinput->event_pool.free_list[class] = entry;
+	libinput->event_pool.count++;
+}
+
+static void
+event_pool_trim(struct libinput *libinput, unsigned int limit)
+{
+	struct event_pool_entry *entry;
+	size_t class = EVENT_POOL_NCLASSES;
+
+	/* Drop the largest events first, they're the least common */
+	while (libinput->event_pool.count > limit && class > 0) {
+		entry = libinput->event_pool.free_list[class - 1];
+		if (!entry) {
+			class--;
+			continue;
+		}
+
+		libinput->event_pool.free_list[class - 1] = entry->next;
+		libinput->event_pool.count--;
+		free(entry);
+	}
+}
+
+static inline void *
+event_zalloc(struct libinput_device *device, size_t size)
+{
+	return event_pool_alloc(device->seat->libinput, size);
+}
+
 int
 libinput_init(struct libinput *libinput,
 	      const struct libinput_interface *interface,
@@ -1687,8 +2126,10 @@ libinput_init(struct libinput *libinput,
 	if (libinput->epoll_fd < 0)
 		return -1;
 
-	libinput->events_len = 4;
+	libinput->events_len = EVENT_QUEUE_DEFAULT_SIZE;
 	libinput->events = zalloc(libinput->events_len * sizeof(*libinput->events));
+	libinput->event_pool.limit = EVENT_POOL_DEFAULT_LIMIT;
+	list_init(&libinput->event_slabs.list);
 	libinput->log_handler = libinput_default_log_func;
 	libinput->log_priority = LIBINPUT_LOG_PRIORITY_ERROR;
 	libinput->interface = interface;
@@ -1699,6 +2140,7 @@ libinput_init(struct libinput *libinput,
 	list_init(&libinput->seat_list);
 	list_init(&libinput->device_group_list);
 	list_init(&libinput->tool_list);
+	list_init(&libinput->open_requests);
 
 	if (libinput_timer_subsys_init(libinput) != 0) {
 		free(libinput->events);
@@ -1749,14 +2191,23 @@ libinput_unref(struct libinput *libinput)
 	if (libinput->refcount > 0)
 		return libinput;
 
+	input_thread_stop(libinput);
+	/* removes all devices, including those kept by an earlier
+	 * suspend */
+	libinput->suspend_mode = LIBINPUT_SUSPEND_REMOVE_DEVICES;
 	libinput_suspend(libinput);
 
 	libinput->interface_backend->destroy(libinput);
+	libinput_open_requests_cancel(libinput, NULL);
 
 	while ((event = libinput_get_event(libinput)))
 	       libinput_event_destroy(event);
 
 	free(libinput->events);
+	event_pool_trim(libinput, 0);
+	event_slab_destroy_all(libinput);
+	trace_destroy(libinput);
+	free(libinput->latency.stats);
 
 	list_for_each_safe(seat, next_seat, &libinput->seat_list, link) {
 		list_for_each_safe(device, next_device,
@@ -1778,6 +2229,10 @@ libinput_unref(struct libinput *libinput)
 		libinput_tablet_tool_unref(tool);
 	}
 
+	if (libinput->read.source)
+		libinput_remove_source(libinput, libinput->read.source);
+	libinput_uring_destroy(libinput->read.uring);
+
 	libinput_timer_subsys_destroy(libinput);
 	libinput_drop_destroyed_sources(libinput);
 	close(libinput->epoll_fd);
@@ -1798,12 +2253,10 @@ libinput_event_tablet_pad_destroy(struct libinput_event_tablet_pad *event)
 	libinput_tablet_pad_mode_group_unref(event->mode_group);
 }
 
-LIBINPUT_EXPORT void
-libinput_event_destroy(struct libinput_event *event)
+/* Drop the references an event holds other than the device */
+static void
+event_release_refs(struct libinput_event *event)
 {
-	if (event == NULL)
-		return;
-
 	switch(event->type) {
 	case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
 	case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
@@ -1821,11 +2274,53 @@ libinput_event_destroy(struct libinput_event *event)
 	default:
 		break;
 	}
+}
 
-	if (event->device)
-		libinput_device_unref(event->device);
+void
+libinput_event_free(struct libinput_event *event)
+{
+	struct libinput *libinput;
+	size_t size;
+
+	event_release_refs(event);
+
+	if (!event->device) {
+		free(event);
+		return;
+	}
+
+	/* The device may be destroyed by the unref below */
+	libinput = event->device->seat->libinput;
+	size = event_size(event->type);
+	libinput_device_unref(event->device);
+
+	event_pool_release(libinput, event, size);
+}
+
+LIBINPUT_EXPORT void
+libinput_event_destroy(struct libinput_event *event)
+{
+	if (event == NULL)
+		return;
+
+	/* With an input thread, the event is handed back to the input
+	 * thread so device and tool refcounts are only ever modified
+	 * there */
+	if (event->device &&
+	    input_thread_release_event(event->device->seat->libinput, event))
+		return;
+
+	libinput_event_free(event);
+}
 
-	free(event);
+LIBINPUT_EXPORT void
+libinput_events_destroy(struct libinput_event **events,
+			size_t nevents)
+{
+	size_t i;
+
+	for (i = 0; i < nevents; i++)
+		libinput_event_destroy(events[i]);
 }
 
 int
@@ -1843,6 +2338,101 @@ close_restricted(struct libinput *libinput, int fd)
 	return libinput->interface->close_restricted(fd, libinput->user_data);
 }
 
+void
+libinput_open_async(struct libinput *libinput,
+		    struct udev_device *udev_device,
+		    const char *seat_name,
+		    int flags,
+		    libinput_open_done_func done)
+{
+	struct libinput_open_request *request;
+
+	request = zalloc(sizeof *request);
+	request->libinput = libinput;
+	request->path = safe_strdup(udev_device_get_devnode(udev_device));
+	request->udev_device = udev_device_ref(udev_device);
+	request->seat_name = safe_strdup(seat_name);
+	request->done = done;
+	request->close_restricted = libinput->interface->close_restricted;
+	request->user_data = libinput->user_data;
+	list_insert(&libinput->open_requests, &request->link);
+
+	/* may complete the request before returning */
+	libinput->interface_async->open_restricted(request,
+						   request->path,
+						   flags,
+						   libinput->user_data);
+}
+
+void
+libinput_open_requests_cancel(struct libinput *libinput,
+			      const char *syspath)
+{
+	struct libinput_open_request *request, *tmp;
+	const char *request_syspath;
+
+	list_for_each_safe(request, tmp, &libinput->open_requests, link) {
+		request_syspath = udev_device_get_syspath(request->udev_device);
+		if (syspath && !streq(syspath, request_syspath))
+			continue;
+
+		list_remove(&request->link);
+		request->libinput = NULL;
+	}
+}
+
+LIBINPUT_EXPORT int
+libinput_set_interface_async(struct libinput *libinput,
+			     const struct libinput_interface_async *interface)
+{
+	if (!libinput->interface_backend->async_open)
+		return -ENOTSUP;
+
+	if (interface && !interface->open_restricted)
+		return -EINVAL;
+
+	libinput->interface_async = interface;
+
+	return 0;
+}
+
+LIBINPUT_EXPORT const char *
+libinput_open_request_get_path(struct libinput_open_request *request)
+{
+	return request->path;
+}
+
+LIBINPUT_EXPORT void
+libinput_open_request_complete(struct libinput_open_request *request,
+			       int fd)
+{
+	struct libinput *libinput = request->libinput;
+
+	if (!libinput) {
+		if (fd >= 0)
+			request->close_restricted(fd, request->user_data);
+	} else {
+		list_remove(&request->link);
+
+		if (fd < 0)
+			log_info(libinput,
+				 "%s: opening input device '%s' failed (%s).\n",
+				 udev_device_get_sysname(request->udev_device),
+				 request->path,
+				 strerror(-fd));
+		else
+			request->done(libinput,
+				      request->udev_device,
+				      request->seat_name,
+				      fd);
+	}
+
+	udev_device_unref(request->udev_device);
+	free(request->seat_name);
+	free(request->path);
+	free(request);
+}
+
 bool
 ignore_litest_test_suite_device(struct udev_device *device)
 {
@@ -1935,6 +2525,12 @@ libinput_device_init(struct libinput_device *device,
 	device->seat = seat;
 	device->refcount = 1;
 	list_init(&device->event_listeners);
+	device->trace_id = ++seat->libinput->trace.last_device_id;
+
+	/* Allocated here rather than on retrieval, the caller may retrieve
+	 * events on a different thread than the one adding devices */
+	if (seat->libinput->latency.enabled)
+		device->latency = zalloc(sizeof *device->latency);
 }
 
 LIBINPUT_EXPORT struct libinput_device *
@@ -1948,6 +2544,7 @@ static void
 libinput_device_destroy(struct libinput_device *device)
 {
 	assert(list_empty(&device->event_listeners));
+	free(device->latency);
 	evdev_device_destroy(evdev_device(device));
 }
 
@@ -1967,11 +2564,14 @@ libinput_device_unref(struct libinput_device *device)
 LIBINPUT_EXPORT int
 libinput_get_fd(struct libinput *libinput)
 {
+	if (libinput->thread)
+		return input_thread_get_fd(libinput);
+
 	return libinput->epoll_fd;
 }
 
-LIBINPUT_EXPORT int
-libinput_dispatch(struct libinput *libinput)
+int
+libinput_dispatch_sources(struct libinput *libinput)
 {
 	struct libinput_source *source;
 	struct epoll_event ep[32];
@@ -1986,38 +2586,69 @@ libinput_dispatch(struct libinput *libinput)
 		if (source->fd == -1)
 			continue;
 
+		if (libinput->latency.enabled)
+			libinput->latency.dispatch_time = libinput_now(libinput);
+
 		source->dispatch(source->user_data);
 	}
 
+	libinput->latency.dispatch_time = 0;
+
 	libinput_drop_destroyed_sources(libinput);
 
 	return 0;
 }
 
+LIBINPUT_EXPORT int
+libinput_dispatch(struct libinput *libinput)
+{
+	if (libinput->thread)
+		return input_thread_dispatch(libinput);
+
+	return libinput_dispatch_sources(libinput);
+}
+
 void
 libinput_device_init_event_listener(struct libinput_event_listener *listener)
 {
 	list_init(&listener->link);
+	listener->device = NULL;
+	listener->types = 0;
 }
 
 void
 libinput_device_add_event_listener(struct libinput_device *device,
 				   struct libinput_event_listener *listener,
+				   uint32_t types,
 				   void (*notify_func)(
 						uint64_t time,
 						struct libinput_event *event,
 						void *notify_func_data),
 				   void *notify_func_data)
 {
+	listener->device = device;
+	listener->types = types;
 	listener->notify_func = notify_func;
 	listener->notify_func_data = notify_func_data;
 	list_insert(&device->event_listeners, &listener->link);
+	device->event_listener_types |= types;
 }
 
 void
 libinput_device_remove_event_listener(struct libinput_event_listener *listener)
 {
+	struct libinput_device *device = listener->device;
+	struct libinput_event_listener *l;
+
 	list_remove(&listener->link);
+	listener->device = NULL;
+
+	if (!device)
+		return;
+
+	device->event_listener_types = 0;
+	list_for_each(l, &device->event_listeners, link)
+		device->event_listener_types |= l->types;
 }
 
 static uint32_t
@@ -2067,8 +2698,17 @@ init_event_base(struct libinput_event *event,
 		struct libinput_device *device,
 		enum libinput_event_type type)
 {
+	struct libinput *libinput = device->seat->libinput;
+
 	event->type = type;
 	event->device = device;
+
+	/* The notify functions overwrite the whole event after
+	 * event_zalloc(), so the storage is recorded here. The storage
+	 * mode only changes through the API, never between allocating
+	 * and posting an event. */
+	event->inline_storage =
+		libinput->event_slabs.storage == LIBINPUT_EVENT_STORAGE_INLINE;
 }
 
 static void
@@ -2081,6 +2721,26 @@ post_base_event(struct libinput_device *device,
 	libinput_post_event(libinput, event);
 }
 
+static inline bool
+event_is_masked(struct libinput_device *device,
+		enum libinput_event_type type)
+{
+	uint32_t mask = device->seat->libinput->event_mask |
+			device->event_mask;
+
+	return (mask & EVENT_TYPE_MASK(type)) != 0;
+}
+
+/* True if an event of this type would be discarded without anyone
+ * seeing it, the notify functions then don't allocate the event at all */
+static inline bool
+event_is_suppressed(struct libinput_device *device,
+		    enum libinput_event_type type)
+{
+	return event_is_masked(device, type) &&
+	       (device->event_listener_types & EVENT_TYPE_MASK(type)) == 0;
+}
+
 static void
 post_device_event(struct libinput_device *device,
 		  uint64_t time,
@@ -2088,6 +2748,7 @@ post_device_event(struct libinput_device *device,
 		  struct libinput_event *event)
 {
 	struct libinput_event_listener *listener, *tmp;
+	uint32_t mask;
 #if 0
 	struct libinput *libinput = device->seat->libinput;
 
@@ -2102,8 +2763,24 @@ post_device_event(struct libinput_device *device,
 
 	init_event_base(event, device, type);
 
-	list_for_each_safe(listener, tmp, &device->event_listeners, link)
-		listener->notify_func(time, event, listener->notify_func_data);
+	mask = EVENT_TYPE_MASK(type);
+	if (device->event_listener_types & mask) {
+		list_for_each_safe(listener, tmp, &device->event_listeners, link) {
+			if (listener->types & mask)
+				listener->notify_func(time,
+						      event,
+						      listener->notify_func_data);
+		}
+	}
+
+	/* Masked but allocated for an internal listener */
+	if (event_is_masked(device, type)) {
+		event_release_refs(event);
+		event_pool_release(device->seat->libinput,
+				   event,
+				   event_size(type));
+		return;
+	}
 
 	libinput_post_event(device->seat->libinput, event);
 }
@@ -2113,7 +2790,7 @@ notify_added_device(struct libinput_device *device)
 {
 	struct libinput_event_device_notify *added_device_event;
 
-	added_device_event = zalloc(sizeof *added_device_event);
+	added_device_event = event_zalloc(device, sizeof *added_device_event);
 
 	post_base_event(device,
 			LIBINPUT_EVENT_DEVICE_ADDED,
@@ -2125,7 +2802,7 @@ notify_removed_device(struct libinput_device *device)
 {
 	struct libinput_event_device_notify *removed_device_event;
 
-	removed_device_event = zalloc(sizeof *removed_device_event);
+	removed_device_event = event_zalloc(device, sizeof *removed_device_event);
 
 	post_base_event(device,
 			LIBINPUT_EVENT_DEVICE_REMOVED,
@@ -2185,7 +2862,12 @@ keyboard_notify_key(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_KEYBOARD))
 		return;
 
-	key_event = zalloc(sizeof *key_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_KEYBOARD_KEY)) {
+		update_seat_key_count(device->seat, key, state);
+		return;
+	}
+
+	key_event = event_zalloc(device, sizeof *key_event);
 
 	seat_key_count = update_seat_key_count(device->seat, key, state);
 
@@ -2212,7 +2894,10 @@ pointer_notify_motion(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	motion_event = zalloc(sizeof *motion_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_POINTER_MOTION))
+		return;
+
+	motion_event = event_zalloc(device, sizeof *motion_event);
 
 	*motion_event = (struct libinput_event_pointer) {
 		.time = time,
@@ -2235,7 +2920,10 @@ pointer_notify_motion_absolute(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	motion_absolute_event = zalloc(sizeof *motion_absolute_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE))
+		return;
+
+	motion_absolute_event = event_zalloc(device, sizeof *motion_absolute_event);
 
 	*motion_absolute_event = (struct libinput_event_pointer) {
 		.time = time,
@@ -2259,7 +2947,12 @@ pointer_notify_button(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	button_event = zalloc(sizeof *button_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_POINTER_BUTTON)) {
+		update_seat_button_count(device->seat, button, state);
+		return;
+	}
+
+	button_event = event_zalloc(device, sizeof *button_event);
 
 	seat_button_count = update_seat_button_count(device->seat,
 						     button,
@@ -2290,7 +2983,10 @@ pointer_notify_axis(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	axis_event = zalloc(sizeof *axis_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_POINTER_AXIS))
+		return;
+
+	axis_event = event_zalloc(device, sizeof *axis_event);
 
 	*axis_event = (struct libinput_event_pointer) {
 		.time = time,
@@ -2317,7 +3013,10 @@ touch_notify_touch_down(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
-	touch_event = zalloc(sizeof *touch_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TOUCH_DOWN))
+		return;
+
+	touch_event = event_zalloc(device, sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch) {
 		.time = time,
@@ -2343,7 +3042,10 @@ touch_notify_touch_motion(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
-	touch_event = zalloc(sizeof *touch_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TOUCH_MOTION))
+		return;
+
+	touch_event = event_zalloc(device, sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch) {
 		.time = time,
@@ -2368,7 +3070,10 @@ touch_notify_touch_up(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
-	touch_event = zalloc(sizeof *touch_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TOUCH_UP))
+		return;
+
+	touch_event = event_zalloc(device, sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch) {
 		.time = time,
@@ -2390,7 +3095,10 @@ touch_notify_frame(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
-	touch_event = zalloc(sizeof *touch_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TOUCH_FRAME))
+		return;
+
+	touch_event = event_zalloc(device, sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch) {
 		.time = time,
@@ -2411,7 +3119,10 @@ tablet_notify_axis(struct libinput_device *device,
 {
 	struct libinput_event_tablet_tool *axis_event;
 
-	axis_event = zalloc(sizeof *axis_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TABLET_TOOL_AXIS))
+		return;
+
+	axis_event = event_zalloc(device, sizeof *axis_event);
 
 	*axis_event = (struct libinput_event_tablet_tool) {
 		.time = time,
@@ -2441,7 +3152,10 @@ tablet_notify_proximity(struct libinput_device *device,
 {
 	struct libinput_event_tablet_tool *proximity_event;
 
-	proximity_event = zalloc(sizeof *proximity_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY))
+		return;
+
+	proximity_event = event_zalloc(device, sizeof *proximity_event);
 
 	*proximity_event = (struct libinput_event_tablet_tool) {
 		.time = time,
@@ -2470,7 +3184,10 @@ tablet_notify_tip(struct libinput_device *device,
 {
 	struct libinput_event_tablet_tool *tip_event;
 
-	tip_event = zalloc(sizeof *tip_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TABLET_TOOL_TIP))
+		return;
+
+	tip_event = event_zalloc(device, sizeof *tip_event);
 
 	*tip_event = (struct libinput_event_tablet_tool) {
 		.time = time,
@@ -2501,7 +3218,12 @@ tablet_notify_button(struct libinput_device *device,
 	struct libinput_event_tablet_tool *button_event;
 	int32_t seat_button_count;
 
-	button_event = zalloc(sizeof *button_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TABLET_TOOL_BUTTON)) {
+		update_seat_button_count(device->seat, button, state);
+		return;
+	}
+
+	button_event = event_zalloc(device, sizeof *button_event);
 
 	seat_button_count = update_seat_button_count(device->seat,
 						     button,
@@ -2534,7 +3256,10 @@ tablet_pad_notify_button(struct libinput_device *device,
 	struct libinput_event_tablet_pad *button_event;
 	unsigned int mode;
 
-	button_event = zalloc(sizeof *button_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TABLET_PAD_BUTTON))
+		return;
+
+	button_event = event_zalloc(device, sizeof *button_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
 
@@ -2563,7 +3288,10 @@ tablet_pad_notify_ring(struct libinput_device *device,
 	struct libinput_event_tablet_pad *ring_event;
 	unsigned int mode;
 
-	ring_event = zalloc(sizeof *ring_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TABLET_PAD_RING))
+		return;
+
+	ring_event = event_zalloc(device, sizeof *ring_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
 
@@ -2593,7 +3321,10 @@ tablet_pad_notify_strip(struct libinput_device *device,
 	struct libinput_event_tablet_pad *strip_event;
 	unsigned int mode;
 
-	strip_event = zalloc(sizeof *strip_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_TABLET_PAD_STRIP))
+		return;
+
+	strip_event = event_zalloc(device, sizeof *strip_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
 
@@ -2628,7 +3359,10 @@ gesture_notify(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_GESTURE))
 		return;
 
-	gesture_event = zalloc(sizeof *gesture_event);
+	if (event_is_suppressed(device, type))
+		return;
+
+	gesture_event = event_zalloc(device, sizeof *gesture_event);
 
 	*gesture_event = (struct libinput_event_gesture) {
 		.time = time,
@@ -2706,7 +3440,10 @@ switch_notify_toggle(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_SWITCH))
 		return;
 
-	switch_event = zalloc(sizeof *switch_event);
+	if (event_is_suppressed(device, LIBINPUT_EVENT_SWITCH_TOGGLE))
+		return;
+
+	switch_event = event_zalloc(device, sizeof *switch_event);
 
 	*switch_event = (struct libinput_event_switch) {
 		.time = time,
@@ -2719,61 +3456,290 @@ switch_notify_toggle(struct libinput_device *device,
 			  &switch_event->base);
 }
 
+static inline size_t
+event_queue_mask(struct libinput *libinput)
+{
+	return libinput->events_len - 1;
+}
+
+/**
+ * Resize the event ring to new_len slots, new_len must be a power of two
+ * and large enough to hold all currently queued events. The queued events
+ * are moved to the start of the new buffer.
+ */
+static int
+libinput_event_queue_resize(struct libinput *libinput, size_t new_len)
+{
+	struct libinput_event **events;
+	size_t count = libinput->events_count;
+	size_t first;
+
+	assert(new_len >= count);
+	assert((new_len & (new_len - 1)) == 0);
+
+	events = calloc(new_len, sizeof *events);
+	if (!events)
+		return -ENOMEM;
+
+	first = min(count, libinput->events_len - libinput->events_out);
+	memcpy(events,
+	       &libinput->events[libinput->events_out],
+	       first * sizeof *events);
+	memcpy(events + first,
+	       libinput->events,
+	       (count - first) * sizeof *events);
+
+	free(libinput->events);
+	libinput->events = events;
+	libinput->events_len = new_len;
+	libinput->events_out = 0;
+	libinput->events_in = count & (new_len - 1);
+
+	return 0;
+}
+
+/* A merged event was queued when its most recent part was queued */
+static inline void
+coalesce_update_latency(struct libinput *libinput,
+			struct libinput_event *queued)
+{
+	if (!libinput->latency.enabled)
+		return;
+
+	queued->dispatch_time = libinput->latency.dispatch_time;
+	queued->queued_time = libinput_now(libinput);
+}
+
+static bool
+coalesce_pointer_motion(struct libinput *libinput,
+			struct libinput_event *last,
+			struct libinput_event *event)
+{
+	struct libinput_event_pointer *queued, *new;
+
+	if (last->type != LIBINPUT_EVENT_POINTER_MOTION ||
+	    last->device != event->device)
+		return false;
+
+	queued = libinput_event_get_pointer_event(last);
+	new = libinput_event_get_pointer_event(event);
+
+	queued->time = new->time;
+	queued->delta.x += new->delta.x;
+	queued->delta.y += new->delta.y;
+	queued->delta_raw.x += new->delta_raw.x;
+	queued->delta_raw.y += new->delta_raw.y;
+	coalesce_update_latency(libinput, last);
+
+	return true;
+}
+
+/**
+ * Find the motion event for seat_slot in the touch frame of device that
+ * ends at offset from the end of the queue, i.e. the frame's TOUCH_FRAME
+ * event is libinput->events[events_in - offset]. Returns NULL if that
+ * frame has no motion for the slot or also has a down, up or cancel for
+ * it.
+ */
+static struct libinput_event_touch *
+coalesce_find_touch_motion(struct libinput *libinput,
+			   size_t offset,
+			   struct libinput_device *device,
+			   int32_t seat_slot)
+{
+	size_t mask = event_queue_mask(libinput);
+	size_t i;
+
+	for (i = offset + 1; i <= libinput->events_count; i++) {
+		struct libinput_event *queued;
+		struct libinput_event_touch *touch;
+
+		queued = libinput->events[(libinput->events_in - i) & mask];
+		if (queued->device != device)
+			continue;
+
+		switch (queued->type) {
+		case LIBINPUT_EVENT_TOUCH_FRAME:
+			return NULL;
+		case LIBINPUT_EVENT_TOUCH_DOWN:
+		case LIBINPUT_EVENT_TOUCH_UP:
+		case LIBINPUT_EVENT_TOUCH_MOTION:
+		case LIBINPUT_EVENT_TOUCH_CANCEL:
+			break;
+		default:
+			continue;
+		}
+
+		touch = libinput_event_get_touch_event(queued);
+		if (touch->seat_slot != seat_slot)
+			continue;
+
+		return queued->type == LIBINPUT_EVENT_TOUCH_MOTION ? touch : NULL;
+	}
+
+	return NULL;
+}
+
+/**
+ * Touch frames are merged when the frame is complete, i.e. when its
+ * TOUCH_FRAME event is posted. The frame is merged into the previous one
+ * only if its events are the last events in the queue, directly after
+ * the previous TOUCH_FRAME of the same device, are all motion events and
+ * the previous frame has a motion event for each of their slots. The
+ * motion events of the previous frame then take the coordinates and
+ * timestamps of the new ones and the new frame is discarded. A frame with
+ * anything else, e.g. a touch down for another slot, is queued as-is so
+ * no event is moved ahead of it.
+ */
+static bool
+coalesce_touch_frame(struct libinput *libinput,
+		     struct libinput_event *event)
+{
+	struct libinput_event_touch *queued, *new;
+	size_t mask = event_queue_mask(libinput);
+	size_t nmotion = 0;
+	size_t i;
+
+	/* The new frame's motion events, up to the previous frame */
+	for (i = 1; i <= libinput->events_count; i++) {
+		struct libinput_event *e;
+
+		e = libinput->events[(libinput->events_in - i) & mask];
+		if (e->device != event->device)
+			return false;
+		if (e->type == LIBINPUT_EVENT_TOUCH_FRAME)
+			break;
+		if (e->type != LIBINPUT_EVENT_TOUCH_MOTION)
+			return false;
+		nmotion++;
+	}
+
+	/* No previous frame in the queue */
+	if (i > libinput->events_count)
+		return false;
+
+	for (i = 1; i <= nmotion; i++) {
+		new = libinput_event_get_touch_event(
+			libinput->events[(libinput->events_in - i) & mask]);
+		if (!coalesce_find_touch_motion(libinput,
+						nmotion + 1,
+						event->device,
+						new->seat_slot))
+			return false;
+	}
+
+	/* Everything can be merged, move the new coordinates into the
+	 * previous frame and drop the new frame's events */
+	while (nmotion--) {
+		struct libinput_event *motion;
+
+		motion = libinput->events[(libinput->events_in - 1) & mask];
+		new = libinput_event_get_touch_event(motion);
+		queued = coalesce_find_touch_motion(libinput,
+						    nmotion + 2,
+						    event->device,
+						    new->seat_slot);
+		queued->time = new->time;
+		queued->point = new->point;
+		coalesce_update_latency(libinput, &queued->base);
+
+		libinput->events_in = (libinput->events_in - 1) & mask;
+		libinput->events_count--;
+		libinput_event_free(motion);
+	}
+
+	queued = libinput_event_get_touch_event(
+			libinput->events[(libinput->events_in - 1) & mask]);
+	new = libinput_event_get_touch_event(event);
+	queued->time = new->time;
+	coalesce_update_latency(libinput, &queued->base);
+
+	return true;
+}
+
+/**
+ * If coalescing is enabled and the event can be merged into the queued
+ * events, merge it and return true. The caller must discard the event in
+ * that case.
+ */
+static bool
+libinput_event_queue_coalesce(struct libinput *libinput,
+			      struct libinput_event *event)
+{
+	struct libinput_event *last;
+	uint32_t flags = libinput->event_coalescing;
+
+	if (flags == LIBINPUT_EVENT_COALESCE_NONE ||
+	    libinput->events_count == 0)
+		return false;
+
+	last = libinput->events[(libinput->events_in - 1) &
+				event_queue_mask(libinput)];
+
+	switch (event->type) {
+	case LIBINPUT_EVENT_POINTER_MOTION:
+		if (flags & LIBINPUT_EVENT_COALESCE_POINTER_MOTION)
+			return coalesce_pointer_motion(libinput, last, event);
+		break;
+	case LIBINPUT_EVENT_TOUCH_FRAME:
+		if (flags & LIBINPUT_EVENT_COALESCE_TOUCH_MOTION)
+			return coalesce_touch_frame(libinput, event);
+		break;
+	default:
+		break;
+	}
+
+	return false;
+}
+
 static void
 libinput_post_event(struct libinput *libinput,
 		    struct libinput_event *event)
 {
-	struct libinput_event **events = libinput->events;
-	size_t events_len = libinput->events_len;
-	size_t events_count = libinput->events_count;
-	size_t move_len;
-	size_t new_out;
-
 #if 0
 	log_debug(libinput, "Queuing %s\n", event_type_to_str(event->type));
 #endif
 
-	events_count++;
-	if (events_count > events_len) {
-		void *tmp;
-
-		events_len *= 2;
-		tmp = realloc(events, events_len * sizeof *events);
-		if (!tmp) {
-			log_error(libinput,
-				  "Failed to reallocate event ring buffer. "
-				  "Events may be discarded\n");
-			return;
-		}
+	if (libinput_event_queue_coalesce(libinput, event)) {
+		event_pool_release(libinput, event, event_size(event->type));
+		return;
+	}
 
-		events = tmp;
-
-		if (libinput->events_count > 0 && libinput->events_in == 0) {
-			libinput->events_in = libinput->events_len;
-		} else if (libinput->events_count > 0 &&
-			   libinput->events_out >= libinput->events_in) {
-			move_len = libinput->events_len - libinput->events_out;
-			new_out = events_len - move_len;
-			memmove(events + new_out,
-				events + libinput->events_out,
-				move_len * sizeof *events);
-			libinput->events_out = new_out;
-		}
+	if (libinput->latency.enabled) {
+		event->dispatch_time = libinput->latency.dispatch_time;
+		event->queued_time = libinput_now(libinput);
+	}
 
-		libinput->events = events;
-		libinput->events_len = events_len;
+	if (libinput_event_queue_push(libinput, event) != 0) {
+		log_error(libinput,
+			  "Failed to reallocate event ring buffer. "
+			  "Events may be discarded\n");
+		return;
 	}
 
 	if (event->device)
 		libinput_device_ref(event->device);
+}
+
+int
+libinput_event_queue_push(struct libinput *libinput,
+			  struct libinput_event *event)
+{
+	if (libinput->events_count == libinput->events_len &&
+	    libinput_event_queue_resize(libinput,
+					libinput->events_len * 2) != 0)
+		return -ENOMEM;
 
-	libinput->events_count = events_count;
-	events[libinput->events_in] = event;
-	libinput->events_in = (libinput->events_in + 1) % libinput->events_len;
+	libinput->events_count++;
+	libinput->events[libinput->events_in] = event;
+	libinput->events_in = (libinput->events_in + 1) &
+				event_queue_mask(libinput);
+
+	return 0;
 }
 
-LIBINPUT_EXPORT struct libinput_event *
-libinput_get_event(struct libinput *libinput)
+struct libinput_event *
+libinput_event_queue_pop(struct libinput *libinput)
 {
 	struct libinput_event *event;
 
@@ -2781,18 +3747,84 @@ libinput_get_event(struct libinput *libinput)
 		return NULL;
 
 	event = libinput->events[libinput->events_out];
-	libinput->events_out =
-		(libinput->events_out + 1) % libinput->events_len;
+	libinput->events_out = (libinput->events_out + 1) &
+				event_queue_mask(libinput);
 	libinput->events_count--;
 
 	return event;
 }
 
+LIBINPUT_EXPORT struct libinput_event *
+libinput_get_event(struct libinput *libinput)
+{
+	struct libinput_event *event;
+
+	if (libinput->thread)
+		event = input_thread_pop_event(libinput);
+	else
+		event = libinput_event_queue_pop(libinput);
+
+	if (event)
+		latency_track_retrieved(libinput, event);
+
+	return event;
+}
+
+LIBINPUT_EXPORT size_t
+libinput_get_events(struct libinput *libinput,
+		    struct libinput_event **events,
+		    size_t nevents)
+{
+	size_t count, first;
+
+	if (libinput->thread) {
+		for (count = 0; count < nevents; count++) {
+			events[count] = libinput_get_event(libinput);
+			if (!events[count])
+				break;
+		}
+		return count;
+	}
+
+	count = min(nevents, libinput->events_count);
+	if (count == 0)
+		return 0;
+
+	/* The ring may wrap, copy up to the end of the buffer first and
+	 * the remainder from the start */
+	first = min(count, libinput->events_len - libinput->events_out);
+	memcpy(events,
+	       &libinput->events[libinput->events_out],
+	       first * sizeof *events);
+	if (count > first)
+		memcpy(events + first,
+		       libinput->events,
+		       (count - first) * sizeof *events);
+
+	libinput->events_out = (libinput->events_out + count) &
+				event_queue_mask(libinput);
+	libinput->events_count -= count;
+
+	if (libinput->latency.enabled) {
+		size_t i;
+
+		for (i = 0; i < count; i++)
+			latency_track_retrieved(libinput, events[i]);
+	}
+
+	return count;
+}
+
 LIBINPUT_EXPORT enum libinput_event_type
 libinput_next_event_type(struct libinput *libinput)
 {
 	struct libinput_event *event;
 
+	if (libinput->thread) {
+		event = input_thread_peek_event(libinput);
+		return event ? event->type : LIBINPUT_EVENT_NONE;
+	}
+
 	if (libinput->events_count == 0)
 		return LIBINPUT_EVENT_NONE;
 
@@ -2800,6 +3832,256 @@ libinput_next_event_type(struct libinput *libinput)
 	return event->type;
 }
 
+LIBINPUT_EXPORT int
+libinput_set_event_queue_capacity(struct libinput *libinput,
+				  size_t capacity)
+{
+	size_t new_len = EVENT_QUEUE_DEFAULT_SIZE;
+
+	if (capacity > EVENT_QUEUE_MAX_SIZE)
+		return -EINVAL;
+
+	while (new_len < capacity)
+		new_len *= 2;
+
+	if (new_len <= libinput->events_len)
+		return 0;
+
+	return libinput_event_queue_resize(libinput, new_len);
+}
+
+LIBINPUT_EXPORT void
+libinput_set_event_coalescing(struct libinput *libinput,
+			      uint32_t flags)
+{
+	libinput->event_coalescing = flags;
+}
+
+LIBINPUT_EXPORT uint32_t
+libinput_get_event_coalescing(struct libinput *libinput)
+{
+	return libinput->event_coalescing;
+}
+
+LIBINPUT_EXPORT int
+libinput_set_event_storage(struct libinput *libinput,
+			   enum libinput_event_storage storage)
+{
+	switch (storage) {
+	case LIBINPUT_EVENT_STORAGE_HEAP:
+	case LIBINPUT_EVENT_STORAGE_INLINE:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	libinput->event_slabs.storage = storage;
+
+	return 0;
+}
+
+LIBINPUT_EXPORT enum libinput_event_storage
+libinput_get_event_storage(struct libinput *libinput)
+{
+	return libinput->event_slabs.storage;
+}
+
+static int
+event_mask_from_types(const enum libinput_event_type *types,
+		      size_t ntypes,
+		      uint32_t *mask)
+{
+	size_t i;
+
+	*mask = 0;
+	for (i = 0; i < ntypes; i++) {
+		switch (types[i]) {
+		case LIBINPUT_EVENT_NONE:
+		case LIBINPUT_EVENT_DEVICE_ADDED:
+		case LIBINPUT_EVENT_DEVICE_REMOVED:
+			return -EINVAL;
+		default:
+			if (event_type_index(types[i]) == -1)
+				return -EINVAL;
+			break;
+		}
+
+		*mask |= EVENT_TYPE_MASK(types[i]);
+	}
+
+	return 0;
+}
+
+static inline int
+event_mask_has_type(uint32_t mask, enum libinput_event_type type)
+{
+	if (event_type_index(type) == -1)
+		return 0;
+
+	return !!(mask & EVENT_TYPE_MASK(type));
+}
+
+LIBINPUT_EXPORT int
+libinput_set_event_mask(struct libinput *libinput,
+			const enum libinput_event_type *types,
+			size_t ntypes)
+{
+	uint32_t mask;
+	int rc;
+
+	rc = event_mask_from_types(types, ntypes, &mask);
+	if (rc == 0)
+		libinput->event_mask = mask;
+
+	return rc;
+}
+
+LIBINPUT_EXPORT int
+libinput_get_event_masked(struct libinput *libinput,
+			  enum libinput_event_type type)
+{
+	return event_mask_has_type(libinput->event_mask, type);
+}
+
+LIBINPUT_EXPORT int
+libinput_device_set_event_mask(struct libinput_device *device,
+			       const enum libinput_event_type *types,
+			       size_t ntypes)
+{
+	uint32_t mask;
+	int rc;
+
+	rc = event_mask_from_types(types, ntypes, &mask);
+	if (rc == 0)
+		device->event_mask = mask;
+
+	return rc;
+}
+
+LIBINPUT_EXPORT int
+libinput_device_get_event_masked(struct libinput_device *device,
+				 enum libinput_event_type type)
+{
+	return event_mask_has_type(device->event_mask, type);
+}
+
+LIBINPUT_EXPORT void
+libinput_set_latency_stats_enabled(struct libinput *libinput,
+				   int enabled)
+{
+	struct libinput_seat *seat;
+	struct libinput_device *device;
+
+	libinput->latency.enabled = !!enabled;
+	if (!enabled)
+		return;
+
+	if (!libinput->latency.stats)
+		libinput->latency.stats = zalloc(sizeof *libinput->latency.stats);
+
+	list_for_each(seat, &libinput->seat_list, link) {
+		list_for_each(device, &seat->devices_list, link) {
+			if (!device->latency)
+				device->latency = zalloc(sizeof *device->latency);
+		}
+	}
+}
+
+LIBINPUT_EXPORT int
+libinput_get_latency_stats_enabled(struct libinput *libinput)
+{
+	return libinput->latency.enabled;
+}
+
+LIBINPUT_EXPORT void
+libinput_reset_latency_stats(struct libinput *libinput)
+{
+	struct libinput_seat *seat;
+	struct libinput_device *device;
+
+	if (libinput->latency.stats)
+		memset(libinput->latency.stats, 0,
+		       sizeof(*libinput->latency.stats));
+
+	list_for_each(seat, &libinput->seat_list, link) {
+		list_for_each(device, &seat->devices_list, link) {
+			if (device->latency)
+				memset(device->latency, 0,
+				       sizeof(*device->latency));
+		}
+	}
+}
+
+LIBINPUT_EXPORT int
+libinput_get_latency_stats(struct libinput *libinput,
+			   struct libinput_device *device,
+			   enum libinput_event_type type,
+			   enum libinput_latency_stage stage,
+			   uint64_t *buckets,
+			   size_t nbuckets)
+{
+	struct latency_stats *stats;
+	int first = 0, last = LATENCY_NEVENT_TYPES - 1;
+	size_t i;
+	int t;
+
+	if (stage > LIBINPUT_LATENCY_STAGE_TOTAL)
+		return -EINVAL;
+
+	if (type != LIBINPUT_EVENT_NONE) {
+		first = event_type_index(type);
+		if (first < 0)
+			return -EINVAL;
+		last = first;
+	}
+
+	nbuckets = min(nbuckets, LATENCY_NBUCKETS);
+	memset(buckets, 0, nbuckets * sizeof(*buckets));
+
+	stats = device ? device->latency : libinput->latency.stats;
+	if (!stats || nbuckets == 0)
+		return nbuckets;
+
+	for (t = first; t <= last; t++) {
+		for (i = 0; i < LATENCY_NBUCKETS; i++) {
+			/* fold the tail into the last requested bucket */
+			size_t b = min(i, nbuckets - 1);
+
+			buckets[b] += stats->buckets[t][stage][i];
+		}
+	}
+
+	return nbuckets;
+}
+
+LIBINPUT_EXPORT void
+libinput_event_pool_set_limit(struct libinput *libinput,
+			      unsigned int limit)
+{
+	libinput->event_pool.limit = limit;
+	event_pool_trim(libinput, limit);
+}
+
+LIBINPUT_EXPORT unsigned int
+libinput_event_pool_get_limit(struct libinput *libinput)
+{
+	return libinput->event_pool.limit;
+}
+
+LIBINPUT_EXPORT void
+libinput_event_pool_get_stats(struct libinput *libinput,
+			      unsigned int *cached,
+			      uint64_t *hits,
+			      uint64_t *misses)
+{
+	if (cached)
+		*cached = libinput->event_pool.count;
+	if (hits)
+		*hits = libinput->event_pool.hits;
+	if (misses)
+		*misses = libinput->event_pool.misses;
+}
+
 LIBINPUT_EXPORT void
 libinput_set_user_data(struct libinput *libinput,
 		       void *user_data)
@@ -2825,6 +4107,75 @@ libinput_suspend(struct libinput *libinput)
 	libinput->interface_backend->suspend(libinput);
 }
 
+LIBINPUT_EXPORT int
+libinput_set_read_backend(struct libinput *libinput,
+			  enum libinput_read_backend backend)
+{
+	struct libinput_uring *uring;
+
+	switch (backend) {
+	case LIBINPUT_READ_BACKEND_EPOLL:
+		break;
+	case LIBINPUT_READ_BACKEND_IO_URING:
+		if (libinput->read.uring)
+			break;
+
+		uring = libinput_uring_create();
+		if (!uring)
+			return -ENOTSUP;
+
+		libinput->read.source =
+			libinput_add_fd(libinput,
+					libinput_uring_get_fd(uring),
+					libinput_uring_dispatch,
+					uring);
+		if (!libinput->read.source) {
+			libinput_uring_destroy(uring);
+			return -ENOMEM;
+		}
+		libinput->read.uring = uring;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	libinput->read.backend = backend;
+
+	return 0;
+}
+
+LIBINPUT_EXPORT enum libinput_read_backend
+libinput_get_read_backend(struct libinput *libinput)
+{
+	return libinput->read.backend;
+}
+
+LIBINPUT_EXPORT int
+libinput_set_suspend_mode(struct libinput *libinput,
+			  enum libinput_suspend_mode mode)
+{
+	switch (mode) {
+	case LIBINPUT_SUSPEND_REMOVE_DEVICES:
+		break;
+	case LIBINPUT_SUSPEND_KEEP_DEVICES:
+		if (!libinput->interface_backend->keep_devices)
+			return -ENOTSUP;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	libinput->suspend_mode = mode;
+
+	return 0;
+}
+
+LIBINPUT_EXPORT enum libinput_suspend_mode
+libinput_get_suspend_mode(struct libinput *libinput)
+{
+	return libinput->suspend_mode;
+}
+
 LIBINPUT_EXPORT void
 libinput_device_set_user_data(struct libinput_device *device, void *user_data)
 {
@@ -3692,6 +5043,56 @@ libinput_device_config_accel_set_curve_point(
 	return device->config.accel->set_curve_point(device, a, fa);
 }
 
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_accel_set_curve(struct libinput_device *device,
+				       const double *a,
+				       const double *fa,
+				       size_t npoints)
+{
+	if (libinput_device_config_accel_get_profile(device) !=
+		    LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE) {
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+	}
+
+	if (npoints > 0 && (!a || !fa))
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	return device->config.accel->set_curve(device, a, fa, npoints);
+}
+
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_accel_set_curve_interpolation(
+		struct libinput_device *device,
+		enum libinput_config_accel_curve_interpolation interpolation)
+{
+	if (libinput_device_config_accel_get_profile(device) !=
+		    LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE) {
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+	}
+
+	switch (interpolation) {
+	case LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR:
+	case LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_MONOTONE_CUBIC:
+		break;
+	default:
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+	}
+
+	return device->config.accel->set_curve_interpolation(device,
+							     interpolation);
+}
+
+LIBINPUT_EXPORT enum libinput_config_accel_curve_interpolation
+libinput_device_config_accel_get_curve_interpolation(
+		struct libinput_device *device)
+{
+	if (libinput_device_config_accel_get_profile(device) !=
+		    LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE)
+		return LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR;
+
+	return device->config.accel->get_curve_interpolation(device);
+}
+
 LIBINPUT_EXPORT uint32_t
 libinput_device_config_accel_get_profiles(struct libinput_device *device)
 {
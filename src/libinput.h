@@ -829,6 +829,22 @@ enum libinput_event_type {
 void
 libinput_event_destroy(struct libinput_event *event);
 
+/**
+ * @ingroup event
+ *
+ * Destroy an array of events, equivalent to calling
+ * libinput_event_destroy() on each event in order.
+ *
+ * @param events An array of events retrieved by libinput_get_events() or
+ * libinput_get_event()
+ * @param nevents The number of events in the array
+ *
+ * @see libinput_get_events
+ */
+void
+libinput_events_destroy(struct libinput_event **events,
+			size_t nevents);
+
 /**
  * @ingroup event
  *
@@ -2954,6 +2970,105 @@ int
 libinput_udev_assign_seat(struct libinput *libinput,
 			  const char *seat_id);
 
+/**
+ * @ingroup base
+ * @struct libinput_open_request
+ *
+ * A pending request to open a device node, see @ref
+ * libinput_interface_async.
+ */
+struct libinput_open_request;
+
+/**
+ * @ingroup base
+ * @struct libinput_interface_async
+ *
+ * An asynchronous alternative to @ref
+ * libinput_interface::open_restricted. Where opening a device node is
+ * expensive, e.g. a round trip to a session manager, libinput issues the
+ * open requests for all devices at once and the caller completes each
+ * with libinput_open_request_complete() once the fd is available.
+ *
+ * @ref libinput_interface::close_restricted is still used to close the
+ * file descriptors.
+ *
+ * @see libinput_set_interface_async
+ */
+struct libinput_interface_async {
+	/**
+	 * Start opening the device at the given path with the flags
+	 * provided. The caller must call libinput_open_request_complete()
+	 * exactly once for each request, either from within this callback
+	 * or later.
+	 *
+	 * @param request The request to complete
+	 * @param path The device path to open
+	 * @param flags Flags as defined by open(2)
+	 * @param user_data The user_data provided when the context was
+	 * created
+	 */
+	void (*open_restricted)(struct libinput_open_request *request,
+				const char *path,
+				int flags,
+				void *user_data);
+};
+
+/**
+ * @ingroup base
+ *
+ * Switch a libinput context created with libinput_udev_create_context()
+ * to asynchronous device opens. Devices found on
+ * libinput_udev_assign_seat(), libinput_resume() and hotplug are then
+ * added once their request is completed, the @ref
+ * LIBINPUT_EVENT_DEVICE_ADDED event is queued at that point.
+ *
+ * This function should be called before libinput_udev_assign_seat(),
+ * devices that are already added are not affected. Contexts created with
+ * libinput_path_create_context() always open synchronously,
+ * libinput_path_add_device() returns the device.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param interface The asynchronous callback interface, or NULL to
+ * revert to @ref libinput_interface::open_restricted
+ *
+ * @return 0 on success, -ENOTSUP for a context created with
+ * libinput_path_create_context(), -EINVAL if the interface is invalid
+ */
+int
+libinput_set_interface_async(struct libinput *libinput,
+			     const struct libinput_interface_async *interface);
+
+/**
+ * @ingroup base
+ *
+ * @param request A pending open request
+ * @return The path of the device node to open
+ */
+const char *
+libinput_open_request_get_path(struct libinput_open_request *request);
+
+/**
+ * @ingroup base
+ *
+ * Complete an open request issued through @ref
+ * libinput_interface_async::open_restricted. libinput takes ownership of
+ * the file descriptor and the request is freed, the caller must not use
+ * it afterwards.
+ *
+ * If the device was removed, the context was suspended or destroyed in
+ * the meantime, the fd is closed with @ref
+ * libinput_interface::close_restricted and no device is added.
+ *
+ * This function must be called from the thread that dispatches the
+ * libinput context.
+ *
+ * @param request A pending open request
+ * @param fd The file descriptor, or a negative errno if the open failed
+ */
+void
+libinput_open_request_complete(struct libinput_open_request *request,
+			       int fd);
+
 /**
  * @ingroup base
  *
@@ -3067,6 +3182,30 @@ libinput_dispatch(struct libinput *libinput);
 struct libinput_event *
 libinput_get_event(struct libinput *libinput);
 
+/**
+ * @ingroup base
+ *
+ * Retrieve up to nevents events from libinput's internal event queue in
+ * one call. The events are written to the caller-supplied array in the
+ * order they would be returned by libinput_get_event().
+ *
+ * After handling the retrieved events, the caller must destroy each of
+ * them using libinput_event_destroy() or libinput_events_destroy().
+ *
+ * @param libinput A previously initialized libinput context
+ * @param events The array to store the events in, must have space for at
+ * least nevents events
+ * @param nevents The maximum number of events to retrieve
+ * @return The number of events stored in the array, or 0 if no event is
+ * available
+ *
+ * @see libinput_events_destroy
+ */
+size_t
+libinput_get_events(struct libinput *libinput,
+		    struct libinput_event **events,
+		    size_t nevents);
+
 /**
  * @ingroup base
  *
@@ -3081,6 +3220,528 @@ libinput_get_event(struct libinput *libinput);
 enum libinput_event_type
 libinput_next_event_type(struct libinput *libinput);
 
+/**
+ * @ingroup base
+ *
+ * Preallocate libinput's internal event queue to hold at least capacity
+ * events without reallocating. The event queue grows as required, this
+ * function allows a caller to avoid reallocations during event processing
+ * by sizing the queue for the expected worst-case number of events
+ * between two calls to libinput_get_event(), e.g. a
+ * SYN_DROPPED recovery on a multi-touch screen.
+ *
+ * The queue is never shrunk, a capacity smaller than the current queue
+ * size has no effect.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param capacity The minimum number of events the queue can hold
+ * @return 0 on success or a negative errno on failure
+ */
+int
+libinput_set_event_queue_capacity(struct libinput *libinput,
+				  size_t capacity);
+
+/**
+ * @ingroup base
+ *
+ * Event coalescing modes, see libinput_set_event_coalescing().
+ */
+enum libinput_event_coalescing {
+	/**
+	 * Every event is queued as-is.
+	 */
+	LIBINPUT_EVENT_COALESCE_NONE = 0,
+	/**
+	 * Consecutive @ref LIBINPUT_EVENT_POINTER_MOTION events from the
+	 * same device are merged into one event while they are still in the
+	 * queue. The accelerated and unaccelerated deltas of the merged
+	 * event are the sums of the individual deltas, the timestamp is the
+	 * timestamp of the most recent event.
+	 */
+	LIBINPUT_EVENT_COALESCE_POINTER_MOTION = (1 << 0),
+	/**
+	 * A touch frame that consists only of @ref
+	 * LIBINPUT_EVENT_TOUCH_MOTION events is merged into the directly
+	 * preceding queued touch frame of the same device, provided that
+	 * frame has a motion event for each of the slots. The queued motion
+	 * events take the coordinates and timestamps of the new events and
+	 * the queued frame takes the timestamp of the new frame.
+	 *
+	 * Frames with a touch down, up or cancel event are never merged, and
+	 * neither is a frame that follows events from another device. Events
+	 * are never moved across frames, each touch frame in the queue
+	 * remains terminated by a @ref LIBINPUT_EVENT_TOUCH_FRAME event.
+	 */
+	LIBINPUT_EVENT_COALESCE_TOUCH_MOTION = (1 << 1),
+};
+
+/**
+ * @ingroup base
+ *
+ * Set the event coalescing mode for this context. Coalescing only
+ * applies to events that have not yet been retrieved with
+ * libinput_get_event(). Pointer motion events are only ever merged with
+ * the most recently queued event, any other event queued in between,
+ * e.g. a button event or an event from a different device, ends the
+ * merge. See @ref libinput_event_coalescing for the touch rules.
+ *
+ * Coalescing is intended for callers that call libinput_dispatch()
+ * infrequently, e.g. once per frame, and only use the accumulated values.
+ *
+ * With an input thread running, events are only coalesced while the
+ * input thread holds them back, i.e. while the caller has not yet
+ * retrieved all previously published events. Events the caller can
+ * already retrieve are never modified. See
+ * libinput_input_thread_start().
+ *
+ * By default, coalescing is disabled.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param flags A bitmask of @ref libinput_event_coalescing
+ *
+ * @see libinput_get_event_coalescing
+ */
+void
+libinput_set_event_coalescing(struct libinput *libinput,
+			      uint32_t flags);
+
+/**
+ * @ingroup base
+ *
+ * Get the event coalescing mode for this context.
+ *
+ * @param libinput A previously initialized libinput context
+ * @return A bitmask of @ref libinput_event_coalescing
+ *
+ * @see libinput_set_event_coalescing
+ */
+uint32_t
+libinput_get_event_coalescing(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Event storage modes, see libinput_set_event_storage().
+ */
+enum libinput_event_storage {
+	/**
+	 * Each event is a separate allocation, recycled through the event
+	 * pool (see libinput_event_pool_set_limit()).
+	 */
+	LIBINPUT_EVENT_STORAGE_HEAP = 0,
+	/**
+	 * Events are stored by value in fixed-size slots of large,
+	 * contiguous buffers. Consecutive events are usually adjacent in
+	 * memory. Memory is only returned once all events in a buffer
+	 * are destroyed.
+	 */
+	LIBINPUT_EVENT_STORAGE_INLINE,
+};
+
+/**
+ * @ingroup base
+ *
+ * Set how events are allocated. Events returned by libinput_get_event()
+ * stay valid until passed to libinput_event_destroy() in either mode.
+ *
+ * The mode may be changed at any time, it only affects events created
+ * afterwards. Event pool statistics (see
+ * libinput_event_pool_get_stats()) only count events in @ref
+ * LIBINPUT_EVENT_STORAGE_HEAP mode.
+ *
+ * By default, the storage mode is @ref LIBINPUT_EVENT_STORAGE_HEAP.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param storage The storage mode
+ * @return 0 on success or -EINVAL for an invalid mode
+ *
+ * @see libinput_get_event_storage
+ */
+int
+libinput_set_event_storage(struct libinput *libinput,
+			   enum libinput_event_storage storage);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @return The event storage mode of this context
+ *
+ * @see libinput_set_event_storage
+ */
+enum libinput_event_storage
+libinput_get_event_storage(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Suppress events of the given types for all devices in this context.
+ * Suppressed events are never queued, libinput's internal state is
+ * updated as usual, e.g. the seat-wide key and button counts still
+ * count suppressed key and button events. Where possible, suppressed
+ * events are not allocated at all.
+ *
+ * Each call replaces the previous mask, pass an empty list to stop
+ * suppressing events. The effective mask of a device is the union of the
+ * context's mask and the mask set with libinput_device_set_event_mask().
+ *
+ * @ref LIBINPUT_EVENT_DEVICE_ADDED and @ref LIBINPUT_EVENT_DEVICE_REMOVED
+ * cannot be suppressed.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param types The event types to suppress
+ * @param ntypes The number of elements in types
+ * @return 0 on success or -EINVAL if any type is invalid, in which case
+ * the mask is left unchanged
+ *
+ * @see libinput_get_event_masked
+ * @see libinput_device_set_event_mask
+ */
+int
+libinput_set_event_mask(struct libinput *libinput,
+			const enum libinput_event_type *types,
+			size_t ntypes);
+
+/**
+ * @ingroup base
+ *
+ * Check if events of the given type are suppressed for this context.
+ * This does not include types suppressed for a single device only.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param type The event type
+ * @return 1 if the type is suppressed, 0 otherwise
+ *
+ * @see libinput_set_event_mask
+ */
+int
+libinput_get_event_masked(struct libinput *libinput,
+			  enum libinput_event_type type);
+
+/**
+ * @ingroup base
+ *
+ * The stages of an event's path through libinput, see
+ * libinput_get_latency_stats().
+ */
+enum libinput_latency_stage {
+	/**
+	 * From the kernel timestamp of the event until libinput started
+	 * processing the file descriptor the event was read from in
+	 * libinput_dispatch().
+	 */
+	LIBINPUT_LATENCY_STAGE_KERNEL = 0,
+	/**
+	 * From the start of processing in libinput_dispatch() until the
+	 * event was queued.
+	 */
+	LIBINPUT_LATENCY_STAGE_PROCESS,
+	/**
+	 * From the event being queued until the caller retrieved it with
+	 * libinput_get_event() or libinput_get_events().
+	 */
+	LIBINPUT_LATENCY_STAGE_QUEUE,
+	/**
+	 * From the kernel timestamp of the event until the caller retrieved
+	 * it.
+	 */
+	LIBINPUT_LATENCY_STAGE_TOTAL,
+};
+
+/**
+ * @ingroup base
+ *
+ * Enable or disable latency tracking for this context. If enabled,
+ * libinput records for each event the time spent in each @ref
+ * libinput_latency_stage, accumulated into histograms per device and per
+ * event type. The statistics are updated when the event is retrieved by
+ * the caller.
+ *
+ * Latency tracking adds a clock lookup for each queued and each retrieved
+ * event and is disabled by default. Disabling latency tracking keeps the
+ * statistics collected so far.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param enabled Non-zero to enable latency tracking, zero to disable it
+ *
+ * @see libinput_get_latency_stats
+ */
+void
+libinput_set_latency_stats_enabled(struct libinput *libinput,
+				   int enabled);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @return Non-zero if latency tracking is enabled, zero otherwise
+ *
+ * @see libinput_set_latency_stats_enabled
+ */
+int
+libinput_get_latency_stats_enabled(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Reset all latency statistics of this context and its devices to zero.
+ *
+ * @param libinput A previously initialized libinput context
+ */
+void
+libinput_reset_latency_stats(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Retrieve a latency histogram for the given stage. Bucket 0 counts
+ * latencies below 1us, bucket n counts latencies in the range of
+ * [2^(n-1), 2^n) microseconds. The last bucket filled in also contains
+ * all latencies beyond its range. libinput fills in at most 20 buckets,
+ * i.e. up to the bucket containing latencies of 2^19us (~0.5s) and
+ * above.
+ *
+ * Events without a kernel timestamp, e.g. @ref
+ * LIBINPUT_EVENT_DEVICE_ADDED, are not counted in @ref
+ * LIBINPUT_LATENCY_STAGE_KERNEL and @ref LIBINPUT_LATENCY_STAGE_TOTAL.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param device The device to get the statistics for, or NULL for the
+ * statistics of all devices in this context
+ * @param type The event type to get the statistics for, or @ref
+ * LIBINPUT_EVENT_NONE for the statistics of all event types
+ * @param stage The stage to get the statistics for
+ * @param[out] buckets The histogram buckets to fill in
+ * @param nbuckets The number of elements in buckets
+ *
+ * @return The number of buckets filled in or a negative errno on failure
+ *
+ * @see libinput_set_latency_stats_enabled
+ */
+int
+libinput_get_latency_stats(struct libinput *libinput,
+			   struct libinput_device *device,
+			   enum libinput_event_type type,
+			   enum libinput_latency_stage stage,
+			   uint64_t *buckets,
+			   size_t nbuckets);
+
+/**
+ * @ingroup base
+ *
+ * Set the maximum number of destroyed events libinput keeps around for
+ * reuse. Events destroyed with libinput_event_destroy() are recycled for
+ * subsequent events instead of being freed, up to this limit. Any events
+ * cached beyond the new limit are freed immediately.
+ *
+ * A limit of 0 disables event recycling, every event is freed on
+ * libinput_event_destroy().
+ *
+ * @param libinput A previously initialized libinput context
+ * @param limit The maximum number of events to keep for reuse
+ *
+ * @see libinput_event_pool_get_limit
+ * @see libinput_event_pool_get_stats
+ */
+void
+libinput_event_pool_set_limit(struct libinput *libinput,
+			      unsigned int limit);
+
+/**
+ * @ingroup base
+ *
+ * Get the maximum number of destroyed events libinput keeps around for
+ * reuse.
+ *
+ * @param libinput A previously initialized libinput context
+ * @return The maximum number of events kept for reuse
+ *
+ * @see libinput_event_pool_set_limit
+ */
+unsigned int
+libinput_event_pool_get_limit(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Get the statistics of the context's event pool. Any of the arguments
+ * may be NULL.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param[out] cached The number of destroyed events currently kept for
+ * reuse
+ * @param[out] hits The number of events allocated from the pool
+ * @param[out] misses The number of events that required a new allocation
+ *
+ * @see libinput_event_pool_set_limit
+ */
+void
+libinput_event_pool_get_stats(struct libinput *libinput,
+			      unsigned int *cached,
+			      uint64_t *hits,
+			      uint64_t *misses);
+
+/**
+ * @ingroup base
+ *
+ * Start a dedicated input thread for this context. The input thread
+ * reads from the device file descriptors, runs the device dispatchers and
+ * timers and publishes the resulting events to the caller. This keeps
+ * libinput's timing-sensitive processing (e.g. tapping, debouncing or
+ * disable-while-typing) independent of how quickly the caller processes
+ * events and reduces the risk of kernel buffer overflows.
+ *
+ * While the input thread is running:
+ * - libinput_get_fd() returns a file descriptor that becomes readable
+ *   whenever new events are available; libinput_dispatch() only resets
+ *   that file descriptor. If the input thread exited on an error, the
+ *   file descriptor becomes readable and libinput_dispatch() returns
+ *   that error as negative errno. The caller should then stop the
+ *   thread with libinput_input_thread_stop() and dispatch from its own
+ *   thread.
+ * - libinput_get_event(), libinput_get_events(), libinput_next_event_type()
+ *   and libinput_event_destroy() may be called from the caller's thread
+ *   without locking, but only from one thread at a time.
+ * - The @ref libinput_interface callbacks and the log handler are invoked
+ *   from the input thread.
+ * - All other functions, including device configuration and adding or
+ *   removing devices, must be called between
+ *   libinput_input_thread_lock() and libinput_input_thread_unlock().
+ *   The exceptions are libinput_input_thread_stop() and libinput_unref(),
+ *   these must be called without holding the lock.
+ * - With event coalescing enabled (see libinput_set_event_coalescing()),
+ *   the input thread holds back new events until the caller has
+ *   retrieved all events published earlier, so they can still be
+ *   coalesced.
+ *
+ * The input thread is stopped with libinput_input_thread_stop() or when
+ * the context is destroyed.
+ *
+ * @param libinput A previously initialized libinput context
+ * @return 0 on success, -EALREADY if the thread is already running or a
+ * negative errno on failure
+ *
+ * @see libinput_input_thread_stop
+ */
+int
+libinput_input_thread_start(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Stop the input thread started with libinput_input_thread_start(). Any
+ * events published by the thread but not yet retrieved by the caller stay
+ * in the queue and are returned by the next call to libinput_get_event().
+ * Afterwards, the context behaves as if the input thread was never
+ * started.
+ *
+ * This function must not be called while holding the lock taken with
+ * libinput_input_thread_lock(), the input thread may be waiting for that
+ * lock. If the calling thread holds the lock, this is logged as a client
+ * bug and the lock is released before the thread is stopped.
+ *
+ * If no input thread is running, this function does nothing.
+ *
+ * @param libinput A previously initialized libinput context
+ */
+void
+libinput_input_thread_stop(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Lock the context against the input thread. Calls to this function may be
+ * nested, each call must be paired with a call to
+ * libinput_input_thread_unlock(). The lock must not be held when calling
+ * libinput_input_thread_stop() or libinput_unref().
+ *
+ * If no input thread is running, this function does nothing.
+ *
+ * @param libinput A previously initialized libinput context
+ *
+ * @see libinput_input_thread_start
+ */
+void
+libinput_input_thread_lock(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Release a lock taken with libinput_input_thread_lock(). Events queued
+ * by the caller while holding the lock, e.g. @ref
+ * LIBINPUT_EVENT_DEVICE_ADDED, are published after the lock is released.
+ *
+ * If no input thread is running, this function does nothing.
+ *
+ * @param libinput A previously initialized libinput context
+ */
+void
+libinput_input_thread_unlock(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Enable the trace ring of this context. While enabled, libinput records
+ * the state transitions of its internal state machines (tapping,
+ * touchpad software buttons, edge scrolling, button debouncing and
+ * gestures) in a ring buffer of nrecords fixed-size records, overwriting
+ * the oldest records once the ring is full. Records are not formatted
+ * until libinput_trace_dump() is called, tracing is cheap enough to be
+ * left enabled permanently, unlike the @ref
+ * LIBINPUT_LOG_PRIORITY_DEBUG log output.
+ *
+ * The size is rounded up to the next power of two. Changing the size
+ * discards all records, a size of 0 disables tracing. By default, tracing
+ * is disabled.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param nrecords The minimum number of records kept, or 0
+ * @return 0 on success, -EINVAL if nrecords exceeds 1048576 or -ENOMEM
+ *
+ * @see libinput_trace_dump
+ */
+int
+libinput_trace_set_size(struct libinput *libinput,
+			unsigned int nrecords);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @return The number of records in the trace ring or 0 if tracing is
+ * disabled
+ *
+ * @see libinput_trace_set_size
+ */
+unsigned int
+libinput_trace_get_size(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Discard all records in the trace ring.
+ *
+ * @param libinput A previously initialized libinput context
+ */
+void
+libinput_trace_clear(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Write the records in the trace ring, oldest first, to the given file
+ * descriptor as human-readable text, one record per line. The format of
+ * the lines is not part of the API. The records remain in the ring.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param fd The file descriptor to write to
+ * @return The number of records written or a negative errno on failure
+ *
+ * @see libinput_trace_set_size
+ */
+int
+libinput_trace_dump(struct libinput *libinput, int fd);
+
 /**
  * @ingroup base
  *
@@ -3134,6 +3795,122 @@ libinput_resume(struct libinput *libinput);
 void
 libinput_suspend(struct libinput *libinput);
 
+/**
+ * @ingroup base
+ *
+ * Determines what libinput_suspend() does with the devices of the
+ * context.
+ */
+enum libinput_suspend_mode {
+	/**
+	 * Devices are removed on libinput_suspend() and added again on
+	 * libinput_resume(), with the respective @ref
+	 * LIBINPUT_EVENT_DEVICE_REMOVED and @ref
+	 * LIBINPUT_EVENT_DEVICE_ADDED events. This is the default.
+	 */
+	LIBINPUT_SUSPEND_REMOVE_DEVICES = 0,
+	/**
+	 * Devices are kept on libinput_suspend(), only their file
+	 * descriptors are closed. On libinput_resume() devices still
+	 * present are reopened and keep their configuration, tools and
+	 * state. Devices that disappeared in the meantime are removed, new
+	 * devices are added as usual.
+	 */
+	LIBINPUT_SUSPEND_KEEP_DEVICES,
+};
+
+/**
+ * @ingroup base
+ *
+ * Set the behavior of libinput_suspend() for this context. Only
+ * contexts created with libinput_udev_create_context() support @ref
+ * LIBINPUT_SUSPEND_KEEP_DEVICES.
+ *
+ * Changing the mode while the context is suspended takes effect on the
+ * next call to libinput_suspend(), devices already kept are resumed or
+ * removed as usual.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param mode The suspend mode
+ *
+ * @return 0 on success, or a negative errno on failure
+ *
+ * @see libinput_get_suspend_mode
+ */
+int
+libinput_set_suspend_mode(struct libinput *libinput,
+			  enum libinput_suspend_mode mode);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @return The current suspend mode
+ *
+ * @see libinput_set_suspend_mode
+ */
+enum libinput_suspend_mode
+libinput_get_suspend_mode(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * How libinput reads events from the device file descriptors.
+ */
+enum libinput_read_backend {
+	/**
+	 * Each device fd is added to the epoll set, its events are read
+	 * with read(2) once it is readable. This is the default.
+	 */
+	LIBINPUT_READ_BACKEND_EPOLL = 0,
+	/**
+	 * A read is kept in flight on every device fd through io_uring.
+	 * libinput_dispatch() processes the data of all devices and
+	 * re-arms all reads with a single system call.
+	 *
+	 * Only the device reads go through io_uring. Timers, the udev
+	 * monitor and the io_uring completion queue itself are still
+	 * watched by the epoll fd returned by libinput_get_fd(), and
+	 * libinput_dispatch() still dispatches them through epoll.
+	 */
+	LIBINPUT_READ_BACKEND_IO_URING,
+};
+
+/**
+ * @ingroup base
+ *
+ * Set the read backend for devices added to or resumed in this context
+ * after this call. The fd returned by libinput_get_fd() and the use of
+ * libinput_dispatch() do not change.
+ *
+ * @ref LIBINPUT_READ_BACKEND_IO_URING requires libinput to be built with
+ * io_uring support and a kernel that supports it, otherwise this
+ * function fails and the context keeps using @ref
+ * LIBINPUT_READ_BACKEND_EPOLL.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param backend The read backend
+ *
+ * @return 0 on success, -ENOTSUP if the backend is not available, or a
+ * negative errno on failure
+ *
+ * @see libinput_get_read_backend
+ */
+int
+libinput_set_read_backend(struct libinput *libinput,
+			  enum libinput_read_backend backend);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @return The read backend used for newly added devices
+ *
+ * @see libinput_set_read_backend
+ */
+enum libinput_read_backend
+libinput_get_read_backend(struct libinput *libinput);
+
 /**
  * @ingroup base
  *
@@ -3174,6 +3951,10 @@ libinput_ref(struct libinput *libinput);
  * // li = libinput_device_get_context(device);
  * @endcode
  *
+ * If an input thread is running, this function must not be called while
+ * holding the lock taken with libinput_input_thread_lock(), see
+ * libinput_input_thread_stop().
+ *
  * @param libinput A previously initialized libinput context
  * @return NULL if context was destroyed otherwise the passed context
  */
@@ -3417,6 +4198,44 @@ libinput_device_set_user_data(struct libinput_device *device, void *user_data);
 void *
 libinput_device_get_user_data(struct libinput_device *device);
 
+/**
+ * @ingroup device
+ *
+ * Suppress events of the given types for this device, in addition to
+ * the types suppressed for the whole context. See
+ * libinput_set_event_mask() for details.
+ *
+ * Each call replaces the previous mask of this device, pass an empty list
+ * to stop suppressing events.
+ *
+ * @param device A previously obtained device
+ * @param types The event types to suppress
+ * @param ntypes The number of elements in types
+ * @return 0 on success or -EINVAL if any type is invalid, in which case
+ * the mask is left unchanged
+ *
+ * @see libinput_device_get_event_masked
+ */
+int
+libinput_device_set_event_mask(struct libinput_device *device,
+			       const enum libinput_event_type *types,
+			       size_t ntypes);
+
+/**
+ * @ingroup device
+ *
+ * Check if events of the given type are suppressed for this device by
+ * libinput_device_set_event_mask(). This does not include the types
+ * suppressed for the whole context.
+ *
+ * @param device A previously obtained device
+ * @param type The event type
+ * @return 1 if the type is suppressed, 0 otherwise
+ */
+int
+libinput_device_get_event_masked(struct libinput_device *device,
+				 enum libinput_event_type type);
+
 /**
  * @ingroup device
  *
@@ -4557,8 +5376,11 @@ libinput_device_config_accel_get_default_speed(struct libinput_device *device);
  * exactly one point on the device's acceleration curve.
  *
  * This function must be called multiple times to define a full acceleration
- * curve. libinput uses linear interpolation between each defined curve
- * point to calculate the appropriate factor. Any speed below or above the
+ * curve, use libinput_device_config_accel_set_curve() to set a full curve
+ * at once. libinput uses linear interpolation between each defined curve
+ * point to calculate the appropriate factor, see
+ * libinput_device_config_accel_set_curve_interpolation() for
+ * alternatives. Any speed below or above the
  * lowest or highest point defined is capped to the factor at the lowest or
  * highest point, respectively. See @ref ptraccel-device-speed for a
  * detailed explanation on this behavior.
@@ -4586,6 +5408,97 @@ enum libinput_config_status
 libinput_device_config_accel_set_curve_point(struct libinput_device *device,
 					     double a, double fa);
 
+/**
+ * @ingroup config
+ *
+ * Replaces the acceleration curve of this device with the given curve
+ * points. This function must be called after setting the type of the
+ * acceleration to @ref LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE.
+ *
+ * The points are given as two arrays of npoints elements each, the point
+ * i is (a[i], fa[i]). The values of a must be in the same range as for
+ * libinput_device_config_accel_set_curve_point() and sorted in strictly
+ * ascending order. A curve may have up to 65536 points. If any point is
+ * invalid, the curve is left unmodified.
+ *
+ * Setting a curve of zero points removes all curve points, the curve is
+ * then a constant factor of 1.
+ *
+ * @param device The device to configure
+ * @param a The input velocities in device units per millisecond
+ * @param fa The unitless factors for each velocity in a
+ * @param npoints The number of elements in a and fa
+ *
+ * @return A config status code
+ *
+ * @see libinput_device_config_accel_set_curve_point
+ * @see libinput_device_config_accel_set_curve_interpolation
+ */
+enum libinput_config_status
+libinput_device_config_accel_set_curve(struct libinput_device *device,
+				       const double *a,
+				       const double *fa,
+				       size_t npoints);
+
+/**
+ * @ingroup config
+ *
+ * The interpolation used between the points of a @ref
+ * LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE acceleration curve.
+ */
+enum libinput_config_accel_curve_interpolation {
+	/**
+	 * Linear interpolation between two neighboring points. This is the
+	 * default.
+	 */
+	LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR = 0,
+	/**
+	 * Monotone cubic interpolation: the curve is smooth across the
+	 * points but never overshoots them, a curve with monotonically
+	 * increasing points increases monotonically.
+	 */
+	LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_MONOTONE_CUBIC,
+};
+
+/**
+ * @ingroup config
+ *
+ * Set the interpolation between the points of the acceleration curve.
+ * This function must be called after setting the type of the
+ * acceleration to @ref LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE.
+ * Switching to a different profile and back resets the interpolation to
+ * @ref LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR.
+ *
+ * @param device The device to configure
+ * @param interpolation The interpolation to use
+ *
+ * @return A config status code
+ *
+ * @see libinput_device_config_accel_get_curve_interpolation
+ */
+enum libinput_config_status
+libinput_device_config_accel_set_curve_interpolation(
+		struct libinput_device *device,
+		enum libinput_config_accel_curve_interpolation interpolation);
+
+/**
+ * @ingroup config
+ *
+ * Get the interpolation between the points of the acceleration curve. If
+ * the device's profile is not @ref
+ * LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE, this function returns
+ * @ref LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR.
+ *
+ * @param device The device to configure
+ *
+ * @return The interpolation used between the curve points
+ *
+ * @see libinput_device_config_accel_set_curve_interpolation
+ */
+enum libinput_config_accel_curve_interpolation
+libinput_device_config_accel_get_curve_interpolation(
+		struct libinput_device *device);
+
 /**
  * @ingroup config
  */
@@ -52,6 +52,115 @@ libinput_timer_destroy(struct libinput_timer *timer)
 	free(timer->timer_name);
 }
 
+/*
+ * Armed timers are kept in a binary min-heap on libinput->timer.heap, each
+ * timer knows its own index so it can be removed or re-keyed in O(log n).
+ * The earliest timer is always heap[0].
+ */
+static inline bool
+timer_heap_less(struct libinput *libinput, size_t a, size_t b)
+{
+	return libinput->timer.heap[a]->expire <
+		libinput->timer.heap[b]->expire;
+}
+
+static inline void
+timer_heap_swap(struct libinput *libinput, size_t a, size_t b)
+{
+	struct libinput_timer **heap = libinput->timer.heap;
+	struct libinput_timer *tmp;
+
+	tmp = heap[a];
+	heap[a] = heap[b];
+	heap[b] = tmp;
+
+	heap[a]->heap_index = a;
+	heap[b]->heap_index = b;
+}
+
+static void
+timer_heap_sift_up(struct libinput *libinput, size_t idx)
+{
+	while (idx > 0) {
+		size_t parent = (idx - 1) / 2;
+
+		if (!timer_heap_less(libinput, idx, parent))
+			break;
+
+		timer_heap_swap(libinput, idx, parent);
+		idx = parent;
+	}
+}
+
+static void
+timer_heap_sift_down(struct libinput *libinput, size_t idx)
+{
+	size_t count = libinput->timer.heap_count;
+
+	while (true) {
+		size_t left = 2 * idx + 1,
+		       right = left + 1,
+		       smallest = idx;
+
+		if (left < count && timer_heap_less(libinput, left, smallest))
+			smallest = left;
+		if (right < count && timer_heap_less(libinput, right, smallest))
+			smallest = right;
+
+		if (smallest == idx)
+			break;
+
+		timer_heap_swap(libinput, idx, smallest);
+		idx = smallest;
+	}
+}
+
+static void
+timer_heap_insert(struct libinput *libinput, struct libinput_timer *timer)
+{
+	if (libinput->timer.heap_count == libinput->timer.heap_size) {
+		size_t new_size = max(libinput->timer.heap_size * 2, 8);
+		struct libinput_timer **heap;
+
+		heap = realloc(libinput->timer.heap, new_size * sizeof(*heap));
+		if (!heap)
+			abort();
+
+		libinput->timer.heap = heap;
+		libinput->timer.heap_size = new_size;
+	}
+
+	timer->heap_index = libinput->timer.heap_count++;
+	libinput->timer.heap[timer->heap_index] = timer;
+	timer_heap_sift_up(libinput, timer->heap_index);
+}
+
+static void
+timer_heap_remove(struct libinput *libinput, struct libinput_timer *timer)
+{
+	size_t idx = timer->heap_index;
+	size_t last = --libinput->timer.heap_count;
+
+	assert(libinput->timer.heap[idx] == timer);
+
+	if (idx != last) {
+		timer_heap_swap(libinput, idx, last);
+		timer_heap_sift_up(libinput, idx);
+		timer_heap_sift_down(libinput, idx);
+	}
+
+	libinput->timer.heap[last] = NULL;
+}
+
+static inline struct libinput_timer *
+timer_heap_peek(struct libinput *libinput)
+{
+	if (libinput->timer.heap_count == 0)
+		return NULL;
+
+	return libinput->timer.heap[0];
+}
+
 static void
 libinput_timer_arm_timer_fd(struct libinput *libinput)
 {
@@ -60,10 +169,13 @@ libinput_timer_arm_timer_fd(struct libinput *libinput)
 	struct itimerspec its = { { 0, 0 }, { 0, 0 } };
 	uint64_t earliest_expire = UINT64_MAX;
 
-	list_for_each(timer, &libinput->timer.list, link) {
-		if (timer->expire < earliest_expire)
-			earliest_expire = timer->expire;
-	}
+	timer = timer_heap_peek(libinput);
+	if (timer)
+		earliest_expire = timer->expire;
+
+	/* Head of the heap hasn't changed, the timerfd is already correct */
+	if (earliest_expire == libinput->timer.next_expiry)
+		return;
 
 	if (earliest_expire != UINT64_MAX) {
 		its.it_value.tv_sec = earliest_expire / ms2us(1000);
@@ -82,16 +194,19 @@ libinput_timer_set_flags(struct libinput_timer *timer,
 			 uint64_t expire,
 			 uint32_t flags)
 {
+	struct libinput *libinput = timer->libinput;
+	uint64_t old_expire = timer->expire;
+
 #ifndef NDEBUG
-	uint64_t now = libinput_now(timer->libinput);
+	uint64_t now = libinput_now(libinput);
 	if (expire < now) {
 		if ((flags & TIMER_FLAG_ALLOW_NEGATIVE) == 0)
-			log_bug_client(timer->libinput,
+			log_bug_client(libinput,
 				       "timer %s: offset negative (-%dms)\n",
 				       timer->timer_name,
 				       us2ms(now - expire));
 	} else if ((expire - now) > ms2us(5000)) {
-		log_bug_libinput(timer->libinput,
+		log_bug_libinput(libinput,
 			 "timer %s: offset more than 5s, now %d expire %d\n",
 			 timer->timer_name,
 			 us2ms(now), us2ms(expire));
@@ -100,11 +215,16 @@ libinput_timer_set_flags(struct libinput_timer *timer,
 
 	assert(expire);
 
-	if (!timer->expire)
-		list_insert(&timer->libinput->timer.list, &timer->link);
-
 	timer->expire = expire;
-	libinput_timer_arm_timer_fd(timer->libinput);
+
+	if (!old_expire)
+		timer_heap_insert(libinput, timer);
+	else if (expire < old_expire)
+		timer_heap_sift_up(libinput, timer->heap_index);
+	else if (expire > old_expire)
+		timer_heap_sift_down(libinput, timer->heap_index);
+
+	libinput_timer_arm_timer_fd(libinput);
 }
 
 void
@@ -119,8 +239,8 @@ libinput_timer_cancel(struct libinput_timer *timer)
 	if (!timer->expire)
 		return;
 
+	timer_heap_remove(timer->libinput, timer);
 	timer->expire = 0;
-	list_remove(&timer->link);
 	libinput_timer_arm_timer_fd(timer->libinput);
 }
 
@@ -129,28 +249,18 @@ libinput_timer_handler(struct libinput *libinput , uint64_t now)
 {
 	struct libinput_timer *timer;
 
-restart:
-	list_for_each(timer, &libinput->timer.list, link) {
-		if (timer->expire == 0)
-			continue;
-
-		if (timer->expire <= now) {
-			/* Clear the timer before calling timer_func,
-			   as timer_func may re-arm it */
-			libinput_timer_cancel(timer);
-			timer->timer_func(now, timer->timer_func_data);
-
-			/*
-			 * Restart the loop. We can't use
-			 * list_for_each_safe() here because that only
-			 * allows removing one (our) timer per timer_func.
-			 * But the timer func may trigger another unrelated
-			 * timer to be cancelled and removed, causing a
-			 * segfault.
-			 */
-			goto restart;
-		}
+	/* The timer func may arm or cancel any timer (including this
+	 * one), so always re-peek the heap instead of iterating */
+	while ((timer = timer_heap_peek(libinput)) &&
+	       timer->expire <= now) {
+		/* Clear the timer before calling timer_func,
+		   as timer_func may re-arm it */
+		timer_heap_remove(libinput, timer);
+		timer->expire = 0;
+		timer->timer_func(now, timer->timer_func_data);
 	}
+
+	libinput_timer_arm_timer_fd(libinput);
 }
 
 static void
@@ -183,8 +293,6 @@ libinput_timer_subsys_init(struct libinput *libinput)
 	if (libinput->timer.fd < 0)
 		return -1;
 
-	list_init(&libinput->timer.list);
-
 	libinput->timer.source = libinput_add_fd(libinput,
 						 libinput->timer.fd,
 						 libinput_timer_dispatch,
@@ -201,10 +309,11 @@ void
 libinput_timer_subsys_destroy(struct libinput *libinput)
 {
 	/* All timer users should have destroyed their timers now */
-	assert(list_empty(&libinput->timer.list));
+	assert(libinput->timer.heap_count == 0);
 
 	libinput_remove_source(libinput, libinput->timer.source);
 	close(libinput->timer.fd);
+	free(libinput->timer.heap);
 }
 
 /**
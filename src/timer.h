@@ -33,7 +33,7 @@ struct libinput;
 struct libinput_timer {
 	struct libinput *libinput;
 	char *timer_name;
-	struct list link;
+	size_t heap_index; /* index into libinput->timer.heap while armed */
 	uint64_t expire; /* in absolute us CLOCK_MONOTONIC */
 	void (*timer_func)(uint64_t now, void *timer_func_data);
 	void *timer_func_data;
@@ -48,6 +48,14 @@ libinput_timer_init(struct libinput_timer *timer, struct libinput *libinput,
 void
 libinput_timer_destroy(struct libinput_timer *timer);
 
+/* Timers embedded in zero-initialized structs may be set up lazily on
+ * first use, cancel and destroy are no-ops until then. */
+static inline bool
+libinput_timer_is_initialized(const struct libinput_timer *timer)
+{
+	return timer->libinput != NULL;
+}
+
 /* Set timer expire time, in absolute us CLOCK_MONOTONIC */
 void
 libinput_timer_set(struct libinput_timer *timer, uint64_t expire);
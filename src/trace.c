@@ -0,0 +1,181 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "libinput-private.h"
+#include "trace.h"
+
+static const char *
+trace_subsystem_to_str(enum trace_subsystem subsystem)
+{
+	switch (subsystem) {
+	case TRACE_TAP:		return "tap";
+	case TRACE_BUTTON:	return "button";
+	case TRACE_EDGE_SCROLL:	return "edge-scroll";
+	case TRACE_DEBOUNCE:	return "debounce";
+	case TRACE_GESTURE:	return "gesture";
+	}
+
+	return "<invalid>";
+}
+
+void
+trace_add_record(struct libinput_device *device,
+		 enum trace_subsystem subsystem,
+		 int touch,
+		 const char *from,
+		 const char *event,
+		 const char *to,
+		 uint64_t time)
+{
+	struct libinput *libinput = device->seat->libinput;
+	struct trace_record *record;
+	size_t idx;
+
+	idx = libinput->trace.count++ & (libinput->trace.size - 1);
+	record = &libinput->trace.records[idx];
+
+	*record = (struct trace_record) {
+		.time = time,
+		.from = from,
+		.event = event,
+		.to = to,
+		.device_id = device->trace_id,
+		.touch = touch,
+		.subsystem = subsystem,
+	};
+}
+
+void
+trace_destroy(struct libinput *libinput)
+{
+	free(libinput->trace.records);
+	libinput->trace.records = NULL;
+	libinput->trace.size = 0;
+	libinput->trace.count = 0;
+}
+
+LIBINPUT_EXPORT int
+libinput_trace_set_size(struct libinput *libinput,
+			unsigned int nrecords)
+{
+	struct trace_record *records;
+	unsigned int size = 1;
+
+	if (nrecords > TRACE_MAX_RECORDS)
+		return -EINVAL;
+
+	if (nrecords == 0) {
+		trace_destroy(libinput);
+		return 0;
+	}
+
+	while (size < nrecords)
+		size <<= 1;
+
+	records = calloc(size, sizeof(*records));
+	if (!records)
+		return -ENOMEM;
+
+	trace_destroy(libinput);
+	libinput->trace.records = records;
+	libinput->trace.size = size;
+
+	return 0;
+}
+
+LIBINPUT_EXPORT unsigned int
+libinput_trace_get_size(struct libinput *libinput)
+{
+	return libinput->trace.size;
+}
+
+LIBINPUT_EXPORT void
+libinput_trace_clear(struct libinput *libinput)
+{
+	libinput->trace.count = 0;
+}
+
+static const char *
+trace_device_name(struct libinput *libinput, unsigned int device_id)
+{
+	struct libinput_seat *seat;
+	struct libinput_device *device;
+
+	list_for_each(seat, &libinput->seat_list, link) {
+		list_for_each(device, &seat->devices_list, link) {
+			if (device->trace_id == device_id)
+				return libinput_device_get_sysname(device);
+		}
+	}
+
+	return NULL;
+}
+
+LIBINPUT_EXPORT int
+libinput_trace_dump(struct libinput *libinput, int fd)
+{
+	struct trace_record *r;
+	uint64_t first, i;
+	const char *name;
+	char device[64];
+	int rc;
+
+	if (!trace_enabled(libinput))
+		return 0;
+
+	first = libinput->trace.count > libinput->trace.size ?
+		libinput->trace.count - libinput->trace.size : 0;
+
+	for (i = first; i < libinput->trace.count; i++) {
+		r = &libinput->trace.records[i & (libinput->trace.size - 1)];
+
+		/* Removed devices are only known by their id */
+		name = trace_device_name(libinput, r->device_id);
+		if (name)
+			snprintf(device, sizeof(device), "%s", name);
+		else
+			snprintf(device, sizeof(device), "device %u", r->device_id);
+
+		rc = dprintf(fd,
+			     "%" PRIu64 ".%06" PRIu64 " %-10s %-11s touch %2d: %s → %s%s%s\n",
+			     r->time / 1000000,
+			     r->time % 1000000,
+			     device,
+			     trace_subsystem_to_str(r->subsystem),
+			     r->touch,
+			     r->from,
+			     r->event ? r->event : "",
+			     r->event ? " → " : "",
+			     r->to);
+		if (rc < 0)
+			return -errno;
+	}
+
+	return (int)(libinput->trace.count - first);
+}
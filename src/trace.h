@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libinput-private.h"
+
+/* Upper limit for libinput_trace_set_size() */
+#define TRACE_MAX_RECORDS (1 << 20)
+
+enum trace_subsystem {
+	TRACE_TAP,
+	TRACE_BUTTON,
+	TRACE_EDGE_SCROLL,
+	TRACE_DEBOUNCE,
+	TRACE_GESTURE,
+};
+
+/* One state machine transition. The strings are the static names
+ * returned by the state machines' *_to_str() helpers, they're only
+ * formatted when the ring is dumped. */
+struct trace_record {
+	uint64_t time;
+	const char *from;
+	const char *event; /* may be NULL */
+	const char *to;
+	unsigned int device_id;
+	int touch; /* touch index or -1 */
+	enum trace_subsystem subsystem;
+};
+
+static inline bool
+trace_enabled(struct libinput *libinput)
+{
+	return libinput->trace.records != NULL;
+}
+
+void
+trace_add_record(struct libinput_device *device,
+		 enum trace_subsystem subsystem,
+		 int touch,
+		 const char *from,
+		 const char *event,
+		 const char *to,
+		 uint64_t time);
+
+/* Record a transition, the arguments are only evaluated if tracing is
+ * enabled */
+#define trace_transition(li_, dev_, ...) \
+	do { \
+		if (trace_enabled(li_)) \
+			trace_add_record((dev_), __VA_ARGS__); \
+	} while (0)
+
+void
+trace_destroy(struct libinput *libinput);
+
+#endif
@@ -44,9 +44,10 @@ static struct udev_seat *
 udev_seat_get_named(struct udev_input *input, const char *seat_name);
 
 static int
-device_added(struct udev_device *udev_device,
-	     struct udev_input *input,
-	     const char *seat_name)
+udev_input_add_device(struct udev_input *input,
+		      struct udev_device *udev_device,
+		      const char *seat_name,
+		      int fd)
 {
 	struct evdev_device *device;
 	const char *devnode, *sysname;
@@ -57,32 +58,29 @@ device_added(struct udev_device *udev_device,
 	if (!device_seat)
 		device_seat = default_seat;
 
-	if (!streq(device_seat, input->seat_id))
-		return 0;
-
-	if (ignore_litest_test_suite_device(udev_device))
-		return 0;
-
 	devnode = udev_device_get_devnode(udev_device);
 	sysname = udev_device_get_sysname(udev_device);
 
-	/* Search for matching logical seat */
-	if (!seat_name)
-		seat_name = udev_device_get_property_value(udev_device, "WL_SEAT");
-	if (!seat_name)
-		seat_name = default_seat_name;
-
 	seat = udev_seat_get_named(input, seat_name);
 
 	if (seat)
 		libinput_seat_ref(&seat->base);
 	else {
 		seat = udev_seat_create(input, device_seat, seat_name);
-		if (!seat)
+		if (!seat) {
+			if (fd >= 0)
+				close_restricted(&input->base, fd);
 			return -1;
+		}
 	}
 
-	device = evdev_device_create(&seat->base, udev_device);
+	/* fd is -1 unless the device was opened asynchronously */
+	if (fd < 0)
+		device = evdev_device_create(&seat->base, udev_device);
+	else
+		device = evdev_device_create_from_fd(&seat->base,
+						     udev_device,
+						     fd);
 	libinput_seat_unref(&seat->base);
 
 	if (device == EVDEV_UNHANDLED_DEVICE) {
@@ -107,6 +105,83 @@ device_added(struct udev_device *udev_device,
 	return 0;
 }
 
+static void
+device_opened(struct libinput *libinput,
+	      struct udev_device *udev_device,
+	      const char *seat_name,
+	      int fd)
+{
+	struct udev_input *input = (struct udev_input*)libinput;
+
+	udev_input_add_device(input, udev_device, seat_name, fd);
+}
+
+static struct evdev_device *
+udev_input_find_suspended_device(struct udev_input *input,
+				 const char *syspath)
+{
+	struct udev_seat *seat;
+	struct evdev_device *device;
+
+	list_for_each(seat, &input->base.seat_list, base.link) {
+		list_for_each(device, &seat->base.devices_list, base.link) {
+			if (device->seat_suspended &&
+			    streq(syspath,
+				  udev_device_get_syspath(device->udev_device)))
+				return device;
+		}
+	}
+
+	return NULL;
+}
+
+static int
+device_added(struct udev_device *udev_device,
+	     struct udev_input *input,
+	     const char *seat_name)
+{
+	struct evdev_device *device;
+	const char *device_seat;
+
+	device_seat = udev_device_get_property_value(udev_device, "ID_SEAT");
+	if (!device_seat)
+		device_seat = default_seat;
+
+	if (!streq(device_seat, input->seat_id))
+		return 0;
+
+	if (ignore_litest_test_suite_device(udev_device))
+		return 0;
+
+	/* Kept across libinput_suspend(), only the fd needs reopening */
+	device = udev_input_find_suspended_device(input,
+				udev_device_get_syspath(udev_device));
+	if (device) {
+		if (evdev_device_seat_resume(device) == 0)
+			return 0;
+
+		evdev_device_remove(device);
+	}
+
+	/* Search for matching logical seat */
+	if (!seat_name)
+		seat_name = udev_device_get_property_value(udev_device, "WL_SEAT");
+	if (!seat_name)
+		seat_name = default_seat_name;
+
+	if (libinput_open_is_async(&input->base)) {
+		if (evdev_device_can_open(&input->base, udev_device))
+			libinput_open_async(&input->base,
+					    udev_device,
+					    seat_name,
+					    EVDEV_OPEN_FLAGS,
+					    device_opened);
+		return 0;
+	}
+
+	return udev_input_add_device(input, udev_device, seat_name, -1);
+}
+
 static void
 device_removed(struct udev_device *udev_device, struct udev_input *input)
 {
@@ -115,6 +190,8 @@ device_removed(struct udev_device *udev_device, struct udev_input *input)
 	const char *syspath;
 
 	syspath = udev_device_get_syspath(udev_device);
+	libinput_open_requests_cancel(&input->base, syspath);
+
 	list_for_each(seat, &input->base.seat_list, base.link) {
 		list_for_each_safe(device, next,
 				   &seat->base.devices_list, base.link) {
@@ -217,19 +294,57 @@ udev_input_remove_devices(struct udev_input *input)
 	}
 }
 
+static void
+udev_input_suspend_devices(struct udev_input *input)
+{
+	struct evdev_device *device;
+	struct udev_seat *seat;
+
+	list_for_each(seat, &input->base.seat_list, base.link) {
+		list_for_each(device, &seat->base.devices_list, base.link)
+			evdev_device_seat_suspend(device);
+	}
+}
+
+/* Remove devices kept across suspend that did not show up again */
+static void
+udev_input_remove_suspended_devices(struct udev_input *input)
+{
+	struct evdev_device *device, *next;
+	struct udev_seat *seat, *tmp;
+
+	list_for_each_safe(seat, tmp, &input->base.seat_list, base.link) {
+		libinput_seat_ref(&seat->base);
+		list_for_each_safe(device, next,
+				   &seat->base.devices_list, base.link) {
+			if (device->seat_suspended)
+				evdev_device_remove(device);
+		}
+		libinput_seat_unref(&seat->base);
+	}
+}
+
 static void
 udev_input_disable(struct libinput *libinput)
 {
 	struct udev_input *input = (struct udev_input*)libinput;
 
-	if (!input->udev_monitor)
-		return;
+	if (input->udev_monitor) {
+		udev_monitor_unref(input->udev_monitor);
+		input->udev_monitor = NULL;
+		libinput_remove_source(&input->base,
+				       input->udev_monitor_source);
+		input->udev_monitor_source = NULL;
+
+		libinput_open_requests_cancel(&input->base, NULL);
 
-	udev_monitor_unref(input->udev_monitor);
-	input->udev_monitor = NULL;
-	libinput_remove_source(&input->base, input->udev_monitor_source);
-	input->udev_monitor_source = NULL;
+		if (libinput->suspend_mode == LIBINPUT_SUSPEND_KEEP_DEVICES) {
+			udev_input_suspend_devices(input);
+			return;
+		}
+	}
 
+	/* no-op unless devices were kept by a previous suspend */
 	udev_input_remove_devices(input);
 }
 
@@ -276,6 +391,8 @@ udev_input_enable(struct libinput *libinput)
 		return -1;
 	}
 
+	udev_input_remove_suspended_devices(input);
+
 	return 0;
 }
 
@@ -350,6 +467,8 @@ static const struct libinput_interface_backend interface_backend = {
 	.suspend = udev_input_disable,
 	.destroy = udev_input_destroy,
 	.device_change_seat = udev_device_change_seat,
+	.async_open = true,
+	.keep_devices = true,
 };
 
 LIBINPUT_EXPORT struct libinput *
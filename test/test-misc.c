@@ -28,6 +28,7 @@
 #include <fcntl.h>
 #include <libinput.h>
 #include <libinput-util.h>
+#include <poll.h>
 #include <unistd.h>
 #include <stdarg.h>
 
@@ -597,6 +598,574 @@ START_TEST(context_ref_counting)
 }
 END_TEST
 
+START_TEST(event_pool_recycle)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	unsigned int cached;
+	uint64_t hits, misses, hits_before;
+	int i;
+
+	ck_assert_int_eq(libinput_event_pool_get_limit(li), 256);
+
+	litest_drain_events(li);
+	libinput_event_pool_get_stats(li, &cached, &hits_before, NULL);
+	ck_assert_int_gt(cached, 0);
+
+	for (i = 0; i < 5; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		libinput_dispatch(li);
+		litest_drain_events(li);
+	}
+
+	libinput_event_pool_get_stats(li, &cached, &hits, &misses);
+	ck_assert_int_ge(hits, hits_before + 5);
+	ck_assert_int_gt(misses, 0);
+
+	libinput_event_pool_set_limit(li, 0);
+	ck_assert_int_eq(libinput_event_pool_get_limit(li), 0);
+	libinput_event_pool_get_stats(li, &cached, NULL, NULL);
+	ck_assert_int_eq(cached, 0);
+
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+	litest_drain_events(li);
+
+	libinput_event_pool_get_stats(li, &cached, NULL, NULL);
+	ck_assert_int_eq(cached, 0);
+}
+END_TEST
+
+START_TEST(event_bulk_retrieval)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *events[6];
+	unsigned int keys[] = { KEY_A, KEY_B, KEY_C, KEY_D, KEY_E,
+				KEY_F, KEY_G, KEY_H, KEY_I, KEY_J };
+	size_t i, n, total = 0;
+
+	litest_drain_events(li);
+
+	ck_assert_int_eq(libinput_get_events(li, events, ARRAY_LENGTH(events)),
+			 0);
+
+	for (i = 0; i < ARRAY_LENGTH(keys); i++) {
+		litest_keyboard_key(dev, keys[i], true);
+		litest_keyboard_key(dev, keys[i], false);
+	}
+	libinput_dispatch(li);
+
+	while ((n = libinput_get_events(li, events, ARRAY_LENGTH(events)))) {
+		ck_assert_int_le(n, ARRAY_LENGTH(events));
+
+		for (i = 0; i < n; i++) {
+			size_t idx = total + i;
+			enum libinput_key_state state;
+
+			state = (idx % 2) ? LIBINPUT_KEY_STATE_RELEASED :
+					    LIBINPUT_KEY_STATE_PRESSED;
+			litest_is_keyboard_event(events[i],
+						 keys[idx / 2],
+						 state);
+		}
+		total += n;
+
+		libinput_events_destroy(events, n);
+	}
+
+	ck_assert_int_eq(total, ARRAY_LENGTH(keys) * 2);
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
+START_TEST(event_queue_capacity)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	int i, count = 0;
+
+	litest_drain_events(li);
+
+	ck_assert_int_eq(libinput_set_event_queue_capacity(li, 0), 0);
+	ck_assert_int_eq(libinput_set_event_queue_capacity(li, 100), 0);
+	ck_assert_int_eq(libinput_set_event_queue_capacity(li, 10), 0);
+	ck_assert_int_eq(libinput_set_event_queue_capacity(li, SIZE_MAX),
+			 -EINVAL);
+
+	/* Queue more events than the capacity to force the ring to grow
+	 * while events are queued */
+	for (i = 0; i < 100; i++) {
+		litest_keyboard_key(dev, KEY_A, true);
+		litest_keyboard_key(dev, KEY_A, false);
+	}
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		litest_is_keyboard_event(event,
+					 KEY_A,
+					 (count % 2) ?
+					 LIBINPUT_KEY_STATE_RELEASED :
+					 LIBINPUT_KEY_STATE_PRESSED);
+		libinput_event_destroy(event);
+		count++;
+	}
+
+	ck_assert_int_eq(count, 200);
+}
+END_TEST
+
+START_TEST(event_input_thread)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct pollfd fds;
+	int epoll_fd;
+	int i, count = 0;
+
+	litest_drain_events(li);
+
+	epoll_fd = libinput_get_fd(li);
+	ck_assert_int_eq(libinput_input_thread_start(li), 0);
+	ck_assert_int_eq(libinput_input_thread_start(li), -EALREADY);
+	ck_assert_int_ne(libinput_get_fd(li), epoll_fd);
+
+	libinput_input_thread_lock(li);
+	libinput_input_thread_lock(li);
+	ck_assert(libinput_device_has_capability(dev->libinput_device,
+						 LIBINPUT_DEVICE_CAP_KEYBOARD));
+	libinput_input_thread_unlock(li);
+	libinput_input_thread_unlock(li);
+
+	for (i = 0; i < 10; i++) {
+		litest_keyboard_key(dev, KEY_A, true);
+		litest_keyboard_key(dev, KEY_A, false);
+	}
+
+	fds.fd = libinput_get_fd(li);
+	fds.events = POLLIN;
+	while (count < 20 && poll(&fds, 1, 2000) > 0) {
+		libinput_dispatch(li);
+		while ((event = libinput_get_event(li))) {
+			litest_is_keyboard_event(event,
+						 KEY_A,
+						 (count % 2) ?
+						 LIBINPUT_KEY_STATE_RELEASED :
+						 LIBINPUT_KEY_STATE_PRESSED);
+			libinput_event_destroy(event);
+			count++;
+		}
+	}
+	ck_assert_int_eq(count, 20);
+
+	/* Events published but not retrieved survive stopping the thread */
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	ck_assert_int_gt(poll(&fds, 1, 2000), 0);
+	libinput_input_thread_stop(li);
+	libinput_input_thread_stop(li);
+	ck_assert_int_eq(libinput_get_fd(li), epoll_fd);
+
+	libinput_dispatch(li);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_PRESSED);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_RELEASED);
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
+START_TEST(event_input_thread_stop_locked)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	int epoll_fd;
+
+	litest_drain_events(li);
+	epoll_fd = libinput_get_fd(li);
+
+	/* Lock and unlock, then stop: the thread must not be left waiting
+	 * for the lock */
+	ck_assert_int_eq(libinput_input_thread_start(li), 0);
+	libinput_input_thread_lock(li);
+	libinput_input_thread_unlock(li);
+	libinput_input_thread_stop(li);
+	ck_assert_int_eq(libinput_get_fd(li), epoll_fd);
+
+	/* Stopping while holding the lock is a client bug but must not
+	 * hang */
+	ck_assert_int_eq(libinput_input_thread_start(li), 0);
+	libinput_input_thread_lock(li);
+	libinput_input_thread_lock(li);
+	litest_set_log_handler_bug(li);
+	libinput_input_thread_stop(li);
+	litest_restore_log_handler(li);
+	ck_assert_int_eq(libinput_get_fd(li), epoll_fd);
+
+	/* No thread anymore, these do nothing */
+	libinput_input_thread_unlock(li);
+	libinput_input_thread_unlock(li);
+
+	/* Unlocking without holding the lock is a client bug */
+	ck_assert_int_eq(libinput_input_thread_start(li), 0);
+	litest_set_log_handler_bug(li);
+	libinput_input_thread_unlock(li);
+	litest_restore_log_handler(li);
+	libinput_input_thread_stop(li);
+}
+END_TEST
+
+START_TEST(event_input_thread_coalesce)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	struct pollfd fds;
+	int i;
+
+	libinput_set_event_coalescing(li,
+				      LIBINPUT_EVENT_COALESCE_POINTER_MOTION);
+	litest_drain_events(li);
+	ck_assert_int_eq(libinput_input_thread_start(li), 0);
+
+	fds.fd = libinput_get_fd(li);
+	fds.events = POLLIN;
+
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	ck_assert_int_gt(poll(&fds, 1, 2000), 0);
+
+	/* The first event is published and not retrieved yet, everything
+	 * after it is held back by the thread and merged */
+	for (i = 0; i < 4; i++) {
+		litest_event(dev, EV_REL, REL_X, 2);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		msleep(10);
+	}
+
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	ptrev = litest_is_motion_event(event);
+	litest_assert_double_eq(libinput_event_pointer_get_dx_unaccelerated(ptrev),
+				1.0);
+	libinput_event_destroy(event);
+
+	/* Running out of events lets the thread publish the rest */
+	ck_assert(libinput_get_event(li) == NULL);
+	ck_assert_int_gt(poll(&fds, 1, 2000), 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	ptrev = litest_is_motion_event(event);
+	litest_assert_double_eq(libinput_event_pointer_get_dx_unaccelerated(ptrev),
+				8.0);
+	libinput_event_destroy(event);
+	ck_assert(libinput_get_event(li) == NULL);
+
+	libinput_input_thread_stop(li);
+	libinput_set_event_coalescing(li, LIBINPUT_EVENT_COALESCE_NONE);
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
+START_TEST(event_mask)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput_event *event;
+	struct libinput_event_keyboard *kev;
+	enum libinput_event_type key = LIBINPUT_EVENT_KEYBOARD_KEY;
+	enum libinput_event_type invalid[] = {
+		LIBINPUT_EVENT_TOUCH_DOWN,
+		LIBINPUT_EVENT_DEVICE_REMOVED,
+	};
+
+	litest_drain_events(li);
+
+	ck_assert_int_eq(libinput_set_event_mask(li, invalid, 2), -EINVAL);
+	ck_assert_int_eq(libinput_get_event_masked(li, LIBINPUT_EVENT_TOUCH_DOWN), 0);
+	ck_assert_int_eq(libinput_set_event_mask(li, &key, 1), 0);
+	ck_assert_int_eq(libinput_get_event_masked(li, key), 1);
+	ck_assert_int_eq(libinput_device_get_event_masked(device, key), 0);
+
+	litest_keyboard_key(dev, KEY_A, true);
+	libinput_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	/* The masked press still counts towards the seat key count */
+	ck_assert_int_eq(libinput_set_event_mask(li, NULL, 0), 0);
+	litest_keyboard_key(dev, KEY_A, false);
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	kev = litest_is_keyboard_event(event,
+				       KEY_A,
+				       LIBINPUT_KEY_STATE_RELEASED);
+	ck_assert_int_eq(libinput_event_keyboard_get_seat_key_count(kev), 0);
+	libinput_event_destroy(event);
+
+	ck_assert_int_eq(libinput_device_set_event_mask(device, &key, 1), 0);
+	ck_assert_int_eq(libinput_device_get_event_masked(device, key), 1);
+	ck_assert_int_eq(libinput_get_event_masked(li, key), 0);
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	libinput_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	ck_assert_int_eq(libinput_device_set_event_mask(device, NULL, 0), 0);
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	libinput_dispatch(li);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_PRESSED);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_RELEASED);
+}
+END_TEST
+
+START_TEST(event_read_backend)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_device *device = dev->libinput_device;
+	enum libinput_config_status status;
+	int rc;
+
+	litest_drain_events(li);
+
+	ck_assert_int_eq(libinput_get_read_backend(li),
+			 LIBINPUT_READ_BACKEND_EPOLL);
+	ck_assert_int_eq(libinput_set_read_backend(li, 3), -EINVAL);
+
+	rc = libinput_set_read_backend(li, LIBINPUT_READ_BACKEND_IO_URING);
+	if (rc == -ENOTSUP) {
+		ck_assert_int_eq(libinput_get_read_backend(li),
+				 LIBINPUT_READ_BACKEND_EPOLL);
+		return;
+	}
+	ck_assert_int_eq(rc, 0);
+	ck_assert_int_eq(libinput_get_read_backend(li),
+			 LIBINPUT_READ_BACKEND_IO_URING);
+
+	/* re-opening the device switches it over */
+	status = libinput_device_config_send_events_set_mode(device,
+			LIBINPUT_CONFIG_SEND_EVENTS_DISABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	status = libinput_device_config_send_events_set_mode(device,
+			LIBINPUT_CONFIG_SEND_EVENTS_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	litest_drain_events(li);
+
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	libinput_dispatch(li);
+
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_PRESSED);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_RELEASED);
+
+	/* back to epoll, the io_uring device keeps working until it is
+	 * re-opened */
+	ck_assert_int_eq(libinput_set_read_backend(li,
+						   LIBINPUT_READ_BACKEND_EPOLL),
+			 0);
+	litest_keyboard_key(dev, KEY_B, true);
+	litest_keyboard_key(dev, KEY_B, false);
+	libinput_dispatch(li);
+
+	litest_assert_key_event(li, KEY_B, LIBINPUT_KEY_STATE_PRESSED);
+	litest_assert_key_event(li, KEY_B, LIBINPUT_KEY_STATE_RELEASED);
+}
+END_TEST
+
+START_TEST(event_storage_inline)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *events[200];
+	size_t i, n;
+
+	litest_drain_events(li);
+
+	ck_assert_int_eq(libinput_get_event_storage(li),
+			 LIBINPUT_EVENT_STORAGE_HEAP);
+	ck_assert_int_eq(libinput_set_event_storage(li, 3), -EINVAL);
+	ck_assert_int_eq(libinput_set_event_storage(li,
+						    LIBINPUT_EVENT_STORAGE_INLINE),
+			 0);
+	ck_assert_int_eq(libinput_get_event_storage(li),
+			 LIBINPUT_EVENT_STORAGE_INLINE);
+
+	/* More events than fit into a single slab */
+	for (i = 0; i < ARRAY_LENGTH(events)/2; i++) {
+		litest_keyboard_key(dev, KEY_A, true);
+		litest_keyboard_key(dev, KEY_A, false);
+	}
+	libinput_dispatch(li);
+
+	n = libinput_get_events(li, events, ARRAY_LENGTH(events));
+	ck_assert_int_eq(n, ARRAY_LENGTH(events));
+
+	/* Inline events stay valid after switching back */
+	ck_assert_int_eq(libinput_set_event_storage(li,
+						    LIBINPUT_EVENT_STORAGE_HEAP),
+			 0);
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	libinput_dispatch(li);
+
+	for (i = 0; i < n; i++)
+		litest_is_keyboard_event(events[i],
+					 KEY_A,
+					 (i % 2) ?
+					 LIBINPUT_KEY_STATE_RELEASED :
+					 LIBINPUT_KEY_STATE_PRESSED);
+	libinput_events_destroy(events, n);
+
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_PRESSED);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_RELEASED);
+}
+END_TEST
+
+START_TEST(event_storage_inline_pool_limit)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	unsigned int limits[] = { 0, 16 };
+	unsigned int *limit;
+	unsigned int cached;
+	int i;
+
+	litest_drain_events(li);
+	libinput_event_pool_set_limit(li, 0);
+	ck_assert_int_eq(libinput_set_event_storage(li,
+						    LIBINPUT_EVENT_STORAGE_INLINE),
+			 0);
+
+	/* Inline events go back to their slab, never to the heap pool,
+	 * whatever the pool limit is */
+	ARRAY_FOR_EACH(limits, limit) {
+		libinput_event_pool_set_limit(li, *limit);
+
+		for (i = 0; i < 40; i++) {
+			litest_keyboard_key(dev, KEY_A, true);
+			litest_keyboard_key(dev, KEY_A, false);
+		}
+		libinput_dispatch(li);
+		litest_drain_events(li);
+
+		libinput_event_pool_get_stats(li, &cached, NULL, NULL);
+		ck_assert_int_eq(cached, 0);
+	}
+
+	/* Heap events still fill the pool up to its limit */
+	ck_assert_int_eq(libinput_set_event_storage(li,
+						    LIBINPUT_EVENT_STORAGE_HEAP),
+			 0);
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	libinput_dispatch(li);
+	litest_drain_events(li);
+
+	libinput_event_pool_get_stats(li, &cached, NULL, NULL);
+	ck_assert_int_gt(cached, 0);
+	ck_assert_int_le(cached, 16);
+
+	libinput_event_pool_set_limit(li, 0);
+}
+END_TEST
+
+static uint64_t
+sum_latency_histogram(struct libinput *li,
+		      struct libinput_device *device,
+		      enum libinput_event_type type,
+		      enum libinput_latency_stage stage)
+{
+	uint64_t buckets[32];
+	uint64_t sum = 0;
+	int i, n;
+
+	n = libinput_get_latency_stats(li, device, type, stage,
+				       buckets, ARRAY_LENGTH(buckets));
+	ck_assert_int_gt(n, 0);
+	ck_assert_int_le(n, ARRAY_LENGTH(buckets));
+
+	for (i = 0; i < n; i++)
+		sum += buckets[i];
+
+	return sum;
+}
+
+START_TEST(event_latency_stats)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_device *device = dev->libinput_device;
+	uint64_t buckets[4];
+	int i;
+
+	litest_drain_events(li);
+
+	ck_assert_int_eq(libinput_get_latency_stats_enabled(li), 0);
+	libinput_set_latency_stats_enabled(li, 1);
+	ck_assert_int_eq(libinput_get_latency_stats_enabled(li), 1);
+
+	for (i = 0; i < 5; i++) {
+		litest_keyboard_key(dev, KEY_A, true);
+		litest_keyboard_key(dev, KEY_A, false);
+	}
+	libinput_dispatch(li);
+	litest_drain_events(li);
+
+	ck_assert_int_eq(sum_latency_histogram(li, NULL,
+					       LIBINPUT_EVENT_NONE,
+					       LIBINPUT_LATENCY_STAGE_QUEUE),
+			 10);
+	ck_assert_int_eq(sum_latency_histogram(li, device,
+					       LIBINPUT_EVENT_KEYBOARD_KEY,
+					       LIBINPUT_LATENCY_STAGE_TOTAL),
+			 10);
+	ck_assert_int_eq(sum_latency_histogram(li, device,
+					       LIBINPUT_EVENT_KEYBOARD_KEY,
+					       LIBINPUT_LATENCY_STAGE_KERNEL),
+			 10);
+	ck_assert_int_eq(sum_latency_histogram(li, device,
+					       LIBINPUT_EVENT_POINTER_MOTION,
+					       LIBINPUT_LATENCY_STAGE_TOTAL),
+			 0);
+
+	/* Fewer buckets fold the tail into the last one */
+	ck_assert_int_eq(libinput_get_latency_stats(li, device,
+						    LIBINPUT_EVENT_KEYBOARD_KEY,
+						    LIBINPUT_LATENCY_STAGE_TOTAL,
+						    buckets, 1),
+			 1);
+	ck_assert_int_eq(buckets[0], 10);
+
+	ck_assert_int_eq(libinput_get_latency_stats(li, device,
+						    LIBINPUT_EVENT_KEYBOARD_KEY,
+						    LIBINPUT_LATENCY_STAGE_TOTAL + 1,
+						    buckets, 4),
+			 -EINVAL);
+
+	libinput_reset_latency_stats(li);
+	ck_assert_int_eq(sum_latency_histogram(li, NULL,
+					       LIBINPUT_EVENT_NONE,
+					       LIBINPUT_LATENCY_STAGE_QUEUE),
+			 0);
+
+	libinput_set_latency_stats_enabled(li, 0);
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	libinput_dispatch(li);
+	litest_drain_events(li);
+	ck_assert_int_eq(sum_latency_histogram(li, device,
+					       LIBINPUT_EVENT_NONE,
+					       LIBINPUT_LATENCY_STAGE_QUEUE),
+			 0);
+}
+END_TEST
+
 START_TEST(config_status_string)
 {
 	const char *strs[3];
@@ -1558,6 +2127,17 @@ TEST_COLLECTION(misc)
 	litest_add_no_device("misc:bitfield_helpers", bitfield_helpers);
 
 	litest_add_no_device("context:refcount", context_ref_counting);
+	litest_add_for_device("context:event-pool", event_pool_recycle, LITEST_MOUSE);
+	litest_add_for_device("events:bulk", event_bulk_retrieval, LITEST_KEYBOARD);
+	litest_add_for_device("events:queue", event_queue_capacity, LITEST_KEYBOARD);
+	litest_add_for_device("events:latency", event_latency_stats, LITEST_KEYBOARD);
+	litest_add_for_device("events:thread", event_input_thread, LITEST_KEYBOARD);
+	litest_add_for_device("events:thread", event_input_thread_stop_locked, LITEST_KEYBOARD);
+	litest_add_for_device("events:thread", event_input_thread_coalesce, LITEST_MOUSE);
+	litest_add_for_device("events:mask", event_mask, LITEST_KEYBOARD);
+	litest_add_for_device("events:storage", event_storage_inline, LITEST_KEYBOARD);
+	litest_add_for_device("events:storage", event_storage_inline_pool_limit, LITEST_KEYBOARD);
+	litest_add_for_device("events:read-backend", event_read_backend, LITEST_KEYBOARD);
 	litest_add_no_device("config:status string", config_status_string);
 
 	litest_add_for_device("timer:offset-warning", timer_offset_bug_warning, LITEST_SYNAPTICS_TOUCHPAD);
@@ -343,6 +343,63 @@ START_TEST(pointer_motion_unaccel)
 }
 END_TEST
 
+START_TEST(pointer_motion_coalesced)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	int i;
+
+	ck_assert_int_eq(libinput_get_event_coalescing(li),
+			 LIBINPUT_EVENT_COALESCE_NONE);
+	libinput_set_event_coalescing(li,
+				      LIBINPUT_EVENT_COALESCE_POINTER_MOTION);
+	ck_assert_int_eq(libinput_get_event_coalescing(li),
+			 LIBINPUT_EVENT_COALESCE_POINTER_MOTION);
+
+	litest_drain_events(li);
+
+	for (i = 0; i < 5; i++) {
+		litest_event(dev, EV_REL, REL_X, 2);
+		litest_event(dev, EV_REL, REL_Y, -1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_button_click_debounced(dev, li, BTN_LEFT, true);
+	for (i = 0; i < 3; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_button_click_debounced(dev, li, BTN_LEFT, false);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	ptrev = litest_is_motion_event(event);
+	litest_assert_double_eq(libinput_event_pointer_get_dx_unaccelerated(ptrev),
+				10.0);
+	litest_assert_double_eq(libinput_event_pointer_get_dy_unaccelerated(ptrev),
+				-5.0);
+	libinput_event_destroy(event);
+
+	litest_assert_button_event(li, BTN_LEFT,
+				   LIBINPUT_BUTTON_STATE_PRESSED);
+
+	event = libinput_get_event(li);
+	ptrev = litest_is_motion_event(event);
+	litest_assert_double_eq(libinput_event_pointer_get_dx_unaccelerated(ptrev),
+				3.0);
+	litest_assert_double_eq(libinput_event_pointer_get_dy_unaccelerated(ptrev),
+				0.0);
+	libinput_event_destroy(event);
+
+	litest_assert_button_event(li, BTN_LEFT,
+				   LIBINPUT_BUTTON_STATE_RELEASED);
+	litest_assert_empty_queue(li);
+
+	libinput_set_event_coalescing(li, LIBINPUT_EVENT_COALESCE_NONE);
+}
+END_TEST
+
 static void
 test_button_event(struct litest_device *dev, unsigned int button, int state)
 {
@@ -1513,6 +1570,87 @@ START_TEST(pointer_accel_profile_flat_motion_relative)
 }
 END_TEST
 
+START_TEST(pointer_accel_profile_curve)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	enum libinput_config_status status;
+	double a[4096], fa[4096];
+	double unsorted[] = { 1.0, 3.0, 2.0 };
+	double invalid[] = { -1.0, 1.0, 60000.0 };
+	double duplicate[] = { 1.0, 1.0, 2.0 };
+	size_t i;
+
+	for (i = 0; i < ARRAY_LENGTH(a); i++) {
+		a[i] = i * 10.0;
+		fa[i] = 2.0;
+	}
+
+	/* not the curve profile */
+	status = libinput_device_config_accel_set_curve(device, a, fa, 10);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_device_config_accel_set_curve_interpolation(device,
+			LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_MONOTONE_CUBIC);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	ck_assert_int_eq(libinput_device_config_accel_get_curve_interpolation(device),
+			 LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR);
+
+	status = libinput_device_config_accel_set_profile(device,
+			LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	status = libinput_device_config_accel_set_curve(device, unsorted, fa,
+							ARRAY_LENGTH(unsorted));
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_device_config_accel_set_curve(device, invalid, fa,
+							ARRAY_LENGTH(invalid));
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_device_config_accel_set_curve(device, duplicate, fa,
+							ARRAY_LENGTH(duplicate));
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_device_config_accel_set_curve(device, NULL, NULL, 0);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	status = libinput_device_config_accel_set_curve(device, a, fa,
+							ARRAY_LENGTH(a));
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	status = libinput_device_config_accel_set_curve_interpolation(device,
+			LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_MONOTONE_CUBIC);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	ck_assert_int_eq(libinput_device_config_accel_get_curve_interpolation(device),
+			 LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_MONOTONE_CUBIC);
+	status = libinput_device_config_accel_set_curve_interpolation(device, 3);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+
+	litest_drain_events(li);
+
+	/* a flat curve is a constant factor at any speed */
+	for (i = 0; i < 10; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		libinput_dispatch(li);
+
+		event = libinput_get_event(li);
+		ptrev = litest_is_motion_event(event);
+		litest_assert_double_eq(libinput_event_pointer_get_dx(ptrev),
+					2.0);
+		libinput_event_destroy(event);
+	}
+
+	/* switching profiles resets the curve and the interpolation */
+	libinput_device_config_accel_set_profile(device,
+			LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE);
+	libinput_device_config_accel_set_profile(device,
+			LIBINPUT_CONFIG_ACCEL_PROFILE_DEVICE_SPEED_CURVE);
+	ck_assert_int_eq(libinput_device_config_accel_get_curve_interpolation(device),
+			 LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR);
+}
+END_TEST
+
 START_TEST(middlebutton)
 {
 	struct litest_device *device = litest_current_device();
@@ -2550,6 +2688,7 @@ TEST_COLLECTION(pointer)
 	litest_add_ranged("pointer:motion", pointer_motion_relative_min_decel, LITEST_RELATIVE, LITEST_POINTINGSTICK, &compass);
 	litest_add("pointer:motion", pointer_motion_absolute, LITEST_ABSOLUTE, LITEST_ANY);
 	litest_add("pointer:motion", pointer_motion_unaccel, LITEST_RELATIVE, LITEST_ANY);
+	litest_add_for_device("pointer:motion", pointer_motion_coalesced, LITEST_MOUSE);
 	litest_add("pointer:button", pointer_button, LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add_no_device("pointer:button", pointer_button_auto_release);
 	litest_add_no_device("pointer:button", pointer_seat_button_count);
@@ -2587,6 +2726,7 @@ TEST_COLLECTION(pointer)
 	litest_add("pointer:accel", pointer_accel_profile_invalid, LITEST_RELATIVE, LITEST_ANY);
 	litest_add("pointer:accel", pointer_accel_profile_noaccel, LITEST_ANY, LITEST_TOUCHPAD|LITEST_RELATIVE|LITEST_TABLET);
 	litest_add("pointer:accel", pointer_accel_profile_flat_motion_relative, LITEST_RELATIVE, LITEST_TOUCHPAD);
+	litest_add("pointer:accel", pointer_accel_profile_curve, LITEST_RELATIVE, LITEST_TOUCHPAD);
 
 	litest_add("pointer:middlebutton", middlebutton, LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add("pointer:middlebutton", middlebutton_nostart_while_down, LITEST_BUTTON, LITEST_CLICKPAD);
@@ -64,6 +64,106 @@ START_TEST(touch_frame_events)
 }
 END_TEST
 
+START_TEST(touch_motion_coalesced)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_touch *tev;
+	double x;
+	int i;
+
+	litest_touch_down(dev, 0, 10, 10);
+	litest_drain_events(li);
+
+	libinput_set_event_coalescing(li,
+				      LIBINPUT_EVENT_COALESCE_TOUCH_MOTION);
+
+	for (i = 1; i <= 5; i++)
+		litest_touch_move(dev, 0, 10 + i * 5, 10);
+	libinput_dispatch(li);
+
+	/* Five frames collapse into one motion event and one frame */
+	event = libinput_get_event(li);
+	tev = litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_MOTION);
+	ck_assert_int_eq(libinput_event_touch_get_seat_slot(tev), 0);
+	x = libinput_event_touch_get_x_transformed(tev, 100);
+	litest_assert_double_ge(x, 34.0);
+	litest_assert_double_le(x, 36.0);
+	libinput_event_destroy(event);
+
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(event);
+
+	litest_assert_empty_queue(li);
+
+	/* A frame with a touch down isn't merged, the motion in it must
+	 * not end up in the previous frame */
+	litest_touch_move(dev, 0, 40, 10);
+	litest_push_event_frame(dev);
+	litest_touch_move(dev, 0, 45, 10);
+	litest_touch_down(dev, 1, 80, 80);
+	litest_pop_event_frame(dev);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	tev = litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_MOTION);
+	x = libinput_event_touch_get_x_transformed(tev, 100);
+	litest_assert_double_ge(x, 39.0);
+	litest_assert_double_le(x, 41.0);
+	libinput_event_destroy(event);
+
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(event);
+
+	for (i = 0; i < 2; i++) {
+		event = libinput_get_event(li);
+		tev = libinput_event_get_touch_event(event);
+		ck_assert_notnull(tev);
+		if (libinput_event_get_type(event) ==
+		    LIBINPUT_EVENT_TOUCH_MOTION) {
+			x = libinput_event_touch_get_x_transformed(tev, 100);
+			litest_assert_double_ge(x, 44.0);
+			litest_assert_double_le(x, 46.0);
+		} else {
+			litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_DOWN);
+		}
+		libinput_event_destroy(event);
+	}
+
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(event);
+
+	litest_touch_up(dev, 1);
+	litest_drain_events(li);
+
+	/* Touch up is never merged, and ends the merge for its frame */
+	litest_touch_move(dev, 0, 50, 10);
+	litest_touch_up(dev, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_MOTION);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_UP);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(event);
+
+	litest_assert_empty_queue(li);
+
+	libinput_set_event_coalescing(li, LIBINPUT_EVENT_COALESCE_NONE);
+}
+END_TEST
+
 START_TEST(touch_abs_transform)
 {
 	struct litest_device *dev;
@@ -1066,6 +1166,7 @@ TEST_COLLECTION(touch)
 	struct range axes = { ABS_X, ABS_Y + 1};
 
 	litest_add("touch:frame", touch_frame_events, LITEST_TOUCH, LITEST_ANY);
+	litest_add_for_device("touch:frame", touch_motion_coalesced, LITEST_GENERIC_MULTITOUCH_SCREEN);
 	litest_add_no_device("touch:abs-transform", touch_abs_transform);
 	litest_add("touch:slots", touch_seat_slot, LITEST_TOUCH, LITEST_TOUCHPAD);
 	litest_add_no_device("touch:slots", touch_many_slots);
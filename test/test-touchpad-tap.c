@@ -56,6 +56,48 @@ START_TEST(touchpad_1fg_tap)
 }
 END_TEST
 
+START_TEST(touchpad_1fg_tap_trace)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	char buf[4096] = {0};
+	int fds[2];
+	int nrecords;
+
+	litest_enable_tap(dev->libinput_device);
+	litest_drain_events(li);
+
+	ck_assert_int_eq(libinput_trace_get_size(li), 0);
+	ck_assert_int_eq(libinput_trace_set_size(li, (1 << 20) + 1), -EINVAL);
+	ck_assert_int_eq(libinput_trace_set_size(li, 5), 0);
+	ck_assert_int_eq(libinput_trace_get_size(li), 8);
+
+	litest_touch_down(dev, 0, 50, 50);
+	litest_touch_up(dev, 0);
+	libinput_dispatch(li);
+	litest_timeout_tap();
+	libinput_dispatch(li);
+	litest_drain_events(li);
+
+	ck_assert_int_eq(pipe2(fds, O_NONBLOCK), 0);
+	nrecords = libinput_trace_dump(li, fds[1]);
+	ck_assert_int_gt(nrecords, 0);
+	ck_assert_int_le(nrecords, 8);
+	ck_assert_int_gt(read(fds[0], buf, sizeof(buf) - 1), 0);
+	ck_assert_notnull(strstr(buf, "tap"));
+	ck_assert_notnull(strstr(buf, "TAP_STATE_IDLE"));
+
+	libinput_trace_clear(li);
+	ck_assert_int_eq(libinput_trace_dump(li, fds[1]), 0);
+
+	ck_assert_int_eq(libinput_trace_set_size(li, 0), 0);
+	ck_assert_int_eq(libinput_trace_get_size(li), 0);
+
+	close(fds[0]);
+	close(fds[1]);
+}
+END_TEST
+
 START_TEST(touchpad_1fg_doubletap)
 {
 	struct litest_device *dev = litest_current_device();
@@ -3416,6 +3458,7 @@ TEST_COLLECTION(touchpad_tap)
 	struct range range_4fg = {0, 4};
 
 	litest_add("tap-1fg:1fg", touchpad_1fg_tap, LITEST_TOUCHPAD, LITEST_ANY);
+	litest_add("tap-1fg:1fg", touchpad_1fg_tap_trace, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("tap-1fg:1fg", touchpad_1fg_doubletap, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add_ranged("tap-multitap:1fg", touchpad_1fg_multitap, LITEST_TOUCHPAD, LITEST_ANY, &multitap_range);
 	litest_add_ranged("tap-multitap:1fg", touchpad_1fg_multitap_timeout, LITEST_TOUCHPAD, LITEST_ANY, &multitap_range);
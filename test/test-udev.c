@@ -394,6 +394,164 @@ START_TEST(udev_suspend_resume)
 }
 END_TEST
 
+static struct libinput_open_request *open_requests[128];
+static size_t nopen_requests;
+
+static void
+open_restricted_async(struct libinput_open_request *request,
+		      const char *path,
+		      int flags,
+		      void *data)
+{
+	ck_assert_str_eq(libinput_open_request_get_path(request), path);
+	ck_assert_int_lt(nopen_requests, ARRAY_LENGTH(open_requests));
+	open_requests[nopen_requests++] = request;
+}
+
+static const struct libinput_interface_async async_interface = {
+	.open_restricted = open_restricted_async,
+};
+
+static void
+complete_open_requests(void)
+{
+	size_t i;
+
+	for (i = 0; i < nopen_requests; i++) {
+		struct libinput_open_request *r = open_requests[i];
+		const char *path = libinput_open_request_get_path(r);
+
+		libinput_open_request_complete(r,
+				open_restricted(path, O_RDWR|O_NONBLOCK|O_CLOEXEC, NULL));
+	}
+	nopen_requests = 0;
+}
+
+START_TEST(udev_async_open)
+{
+	struct libinput *li;
+	struct udev *udev;
+	int num_devices = 0;
+
+	udev = udev_new();
+	ck_assert(udev != NULL);
+
+	li = libinput_udev_create_context(&simple_interface, NULL, udev);
+	ck_assert(li != NULL);
+	ck_assert_int_eq(libinput_set_interface_async(li, &async_interface), 0);
+
+	nopen_requests = 0;
+	ck_assert_int_eq(libinput_udev_assign_seat(li, "seat0"), 0);
+	ck_assert_int_gt(nopen_requests, 0);
+
+	/* nothing is added until the requests complete */
+	ck_assert_int_ge(libinput_dispatch(li), 0);
+	process_events_count_devices(li, &num_devices);
+	ck_assert_int_eq(num_devices, 0);
+
+	complete_open_requests();
+	ck_assert_int_ge(libinput_dispatch(li), 0);
+	process_events_count_devices(li, &num_devices);
+	ck_assert_int_gt(num_devices, 0);
+
+	/* requests completed after a suspend are dropped */
+	libinput_suspend(li);
+	libinput_resume(li);
+	ck_assert_int_gt(nopen_requests, 0);
+	libinput_suspend(li);
+	complete_open_requests();
+	ck_assert_int_ge(libinput_dispatch(li), 0);
+	process_events_count_devices(li, &num_devices);
+	ck_assert_int_eq(num_devices, 0);
+
+	/* and so are requests outliving the context */
+	libinput_resume(li);
+	ck_assert_int_gt(nopen_requests, 0);
+	libinput_unref(li);
+	complete_open_requests();
+
+	udev_unref(udev);
+}
+END_TEST
+
+START_TEST(udev_async_open_path)
+{
+	struct libinput *li;
+
+	li = libinput_path_create_context(&simple_interface, NULL);
+	ck_assert(li != NULL);
+	ck_assert_int_eq(libinput_set_interface_async(li, &async_interface),
+			 -ENOTSUP);
+	libinput_unref(li);
+}
+END_TEST
+
+START_TEST(udev_suspend_keep_devices)
+{
+	struct libinput *li;
+	struct udev *udev;
+	int num_devices = 0;
+	int num_after;
+
+	udev = udev_new();
+	ck_assert(udev != NULL);
+
+	li = libinput_udev_create_context(&simple_interface, NULL, udev);
+	ck_assert(li != NULL);
+	ck_assert_int_eq(libinput_get_suspend_mode(li),
+			 LIBINPUT_SUSPEND_REMOVE_DEVICES);
+	ck_assert_int_eq(libinput_set_suspend_mode(li,
+					LIBINPUT_SUSPEND_KEEP_DEVICES),
+			 0);
+	ck_assert_int_eq(libinput_get_suspend_mode(li),
+			 LIBINPUT_SUSPEND_KEEP_DEVICES);
+	ck_assert_int_eq(libinput_udev_assign_seat(li, "seat0"), 0);
+
+	ck_assert_int_ge(libinput_dispatch(li), 0);
+	process_events_count_devices(li, &num_devices);
+	ck_assert_int_gt(num_devices, 0);
+
+	/* devices are neither removed nor re-added */
+	num_after = num_devices;
+	libinput_suspend(li);
+	ck_assert_int_ge(libinput_dispatch(li), 0);
+	process_events_count_devices(li, &num_after);
+	ck_assert_int_eq(num_after, num_devices);
+
+	libinput_resume(li);
+	ck_assert_int_ge(libinput_dispatch(li), 0);
+	process_events_count_devices(li, &num_after);
+	ck_assert_int_eq(num_after, num_devices);
+
+	/* switching back removes the kept devices on suspend */
+	ck_assert_int_eq(libinput_set_suspend_mode(li,
+					LIBINPUT_SUSPEND_REMOVE_DEVICES),
+			 0);
+	libinput_suspend(li);
+	ck_assert_int_ge(libinput_dispatch(li), 0);
+	process_events_count_devices(li, &num_after);
+	ck_assert_int_eq(num_after, 0);
+
+	libinput_unref(li);
+	udev_unref(udev);
+}
+END_TEST
+
+START_TEST(udev_suspend_keep_devices_path)
+{
+	struct libinput *li;
+
+	li = libinput_path_create_context(&simple_interface, NULL);
+	ck_assert(li != NULL);
+	ck_assert_int_eq(libinput_set_suspend_mode(li,
+					LIBINPUT_SUSPEND_KEEP_DEVICES),
+			 -ENOTSUP);
+	ck_assert_int_eq(libinput_get_suspend_mode(li),
+			 LIBINPUT_SUSPEND_REMOVE_DEVICES);
+	libinput_unref(li);
+}
+END_TEST
+
 START_TEST(udev_resume_before_seat)
 {
 	struct libinput *li;
@@ -661,6 +819,10 @@ TEST_COLLECTION(udev)
 	litest_add_for_device("udev:suspend", udev_suspend_resume, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device("udev:suspend", udev_resume_before_seat, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device("udev:suspend", udev_suspend_resume_before_seat, LITEST_SYNAPTICS_CLICKPAD_X220);
+	litest_add_for_device("udev:suspend", udev_suspend_keep_devices, LITEST_SYNAPTICS_CLICKPAD_X220);
+	litest_add_no_device("udev:suspend", udev_suspend_keep_devices_path);
+	litest_add_for_device("udev:async", udev_async_open, LITEST_SYNAPTICS_CLICKPAD_X220);
+	litest_add_no_device("udev:async", udev_async_open_path);
 	litest_add_for_device("udev:device events", udev_device_sysname, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device("udev:seat", udev_seat_recycle, LITEST_SYNAPTICS_CLICKPAD_X220);
 
@@ -0,0 +1,269 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <libevdev/libevdev.h>
+#include <libevdev/libevdev-uinput.h>
+
+#include "libinput-util.h"
+
+/* Same as EVDEV_READ_BATCH_SIZE in src/evdev.c */
+#define READ_BATCH_SIZE 64
+
+/* Replicates the event read paths of evdev_device_dispatch(): the
+ * libevdev_next_event() loop and the bulk read() that keeps libevdev's
+ * state in sync with libevdev_set_event_value(). Only the read path is
+ * measured, the events are not processed any further. */
+
+static inline uint64_t
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static size_t
+drain_libevdev(struct libevdev *evdev)
+{
+	struct input_event ev;
+	size_t count = 0;
+	int rc;
+
+	do {
+		rc = libevdev_next_event(evdev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
+		if (rc == LIBEVDEV_READ_STATUS_SUCCESS)
+			count++;
+	} while (rc == LIBEVDEV_READ_STATUS_SUCCESS);
+
+	return count;
+}
+
+static size_t
+drain_batch(struct libevdev *evdev, int fd)
+{
+	struct input_event ev[READ_BATCH_SIZE];
+	size_t i, nevents, count = 0;
+	ssize_t len;
+
+	do {
+		len = read(fd, ev, sizeof(ev));
+		if (len < 0)
+			break;
+
+		nevents = len / sizeof(ev[0]);
+		for (i = 0; i < nevents; i++) {
+			switch (ev[i].type) {
+			case EV_SYN:
+				break;
+			case EV_KEY:
+			case EV_ABS:
+			case EV_SW:
+			case EV_LED:
+				if (libevdev_set_event_value(evdev,
+							     ev[i].type,
+							     ev[i].code,
+							     ev[i].value) != 0)
+					continue;
+				break;
+			default:
+				if (!libevdev_has_event_code(evdev,
+							     ev[i].type,
+							     ev[i].code))
+					continue;
+				break;
+			}
+			count++;
+		}
+	} while (nevents == ARRAY_LENGTH(ev));
+
+	return count;
+}
+
+static void
+write_frames(struct libevdev_uinput *uinput, int nframes)
+{
+	int i;
+
+	for (i = 0; i < nframes; i++) {
+		libevdev_uinput_write_event(uinput, EV_REL, REL_X, 1);
+		libevdev_uinput_write_event(uinput, EV_REL, REL_Y, -1);
+		libevdev_uinput_write_event(uinput, EV_KEY, BTN_LEFT, i % 2);
+		libevdev_uinput_write_event(uinput, EV_SYN, SYN_REPORT, 0);
+	}
+}
+
+static void
+usage(void)
+{
+	printf("Usage: %s [options]\n", program_invocation_short_name);
+	printf("\n"
+	       "Creates a uinput mouse and measures the time to read its events\n"
+	       "with libevdev_next_event() and with bulk reads. Requires\n"
+	       "access to /dev/uinput.\n"
+	       "\n"
+	       "Options:\n"
+	       "--iterations=<int> ... number of write/read cycles (default: 10000)\n"
+	       "--frames=<int>     ... frames written per cycle, 1-15 (default: 8)\n"
+	       "--help             ... show this help\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	struct libevdev *evdev, *uinput_template;
+	struct libevdev_uinput *uinput;
+	int iterations = 10000;
+	int nframes = 8;
+	uint64_t elapsed[2] = {0};
+	size_t nevents[2] = {0};
+	int fd, i, rc;
+
+	enum {
+		OPT_HELP = 1,
+		OPT_ITERATIONS,
+		OPT_FRAMES,
+	};
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{"iterations", 1, 0, OPT_ITERATIONS },
+			{"frames", 1, 0, OPT_FRAMES },
+			{0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "",
+				long_options, &option_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		case OPT_ITERATIONS:
+			if (!safe_atoi(optarg, &iterations) || iterations <= 0) {
+				usage();
+				return 1;
+			}
+			break;
+		case OPT_FRAMES:
+			/* The kernel's evdev buffer holds at least 64
+			 * events, stay below it to avoid SYN_DROPPED */
+			if (!safe_atoi(optarg, &nframes) ||
+			    nframes <= 0 || nframes > 15) {
+				usage();
+				return 1;
+			}
+			break;
+		default:
+			usage();
+			return 1;
+		}
+	}
+
+	uinput_template = libevdev_new();
+	libevdev_set_name(uinput_template, "evdev read benchmark mouse");
+	libevdev_enable_event_code(uinput_template, EV_REL, REL_X, NULL);
+	libevdev_enable_event_code(uinput_template, EV_REL, REL_Y, NULL);
+	libevdev_enable_event_code(uinput_template, EV_KEY, BTN_LEFT, NULL);
+	libevdev_enable_event_code(uinput_template, EV_KEY, BTN_RIGHT, NULL);
+
+	rc = libevdev_uinput_create_from_device(uinput_template,
+						LIBEVDEV_UINPUT_OPEN_MANAGED,
+						&uinput);
+	libevdev_free(uinput_template);
+	if (rc != 0) {
+		fprintf(stderr, "Failed to create uinput device: %s\n",
+			strerror(-rc));
+		return 1;
+	}
+
+	/* let udev create the device node */
+	usleep(200000);
+
+	fd = open(libevdev_uinput_get_devnode(uinput), O_RDONLY|O_NONBLOCK);
+	if (fd < 0) {
+		fprintf(stderr, "Failed to open %s: %s\n",
+			libevdev_uinput_get_devnode(uinput), strerror(errno));
+		libevdev_uinput_destroy(uinput);
+		return 1;
+	}
+
+	rc = libevdev_new_from_fd(fd, &evdev);
+	if (rc != 0) {
+		fprintf(stderr, "Failed to init device: %s\n", strerror(-rc));
+		close(fd);
+		libevdev_uinput_destroy(uinput);
+		return 1;
+	}
+	libevdev_set_clock_id(evdev, CLOCK_MONOTONIC);
+
+	/* alternate between the two so both see the same system state */
+	for (i = 0; i < iterations * 2; i++) {
+		int mode = i % 2;
+		uint64_t start;
+
+		write_frames(uinput, nframes);
+
+		start = now_ns();
+		if (mode == 0)
+			nevents[mode] += drain_libevdev(evdev);
+		else
+			nevents[mode] += drain_batch(evdev, fd);
+		elapsed[mode] += now_ns() - start;
+	}
+
+	printf("%-20s %10s %12s %10s\n", "# mode", "events", "total (us)", "ns/event");
+	printf("%-20s %10zu %12.1f %10.1f\n",
+	       "libevdev_next_event",
+	       nevents[0],
+	       elapsed[0] / 1000.0,
+	       nevents[0] ? (double)elapsed[0] / nevents[0] : 0.0);
+	printf("%-20s %10zu %12.1f %10.1f\n",
+	       "batch read",
+	       nevents[1],
+	       elapsed[1] / 1000.0,
+	       nevents[1] ? (double)elapsed[1] / nevents[1] : 0.0);
+
+	libevdev_free(evdev);
+	close(fd);
+	libevdev_uinput_destroy(uinput);
+
+	return 0;
+}
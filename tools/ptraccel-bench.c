@@ -0,0 +1,659 @@
+/*
+ * Copyright © 2018 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <getopt.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "filter.h"
+#include "filter-private.h"
+#include "libinput-util.h"
+
+#define MOTION_TIMEOUT		ms2us(1000)
+#define NTRACKERS		16
+
+/* The tracker implementation before the switch to running sums and a
+ * ring sized by report rate: a fixed ring of 16 trackers, every feed adds
+ * the delta to all of them and every velocity calculation walks them.
+ * Kept here as the baseline for the comparison. */
+
+struct legacy_tracker {
+	struct device_float_coords delta;
+	uint64_t time;
+	uint32_t dir;
+};
+
+struct legacy_trackers {
+	struct legacy_tracker trackers[NTRACKERS];
+	unsigned int cur_tracker;
+};
+
+static inline struct legacy_tracker *
+legacy_by_offset(struct legacy_trackers *trackers, unsigned int offset)
+{
+	unsigned int index = (trackers->cur_tracker + NTRACKERS - offset) %
+			     NTRACKERS;
+
+	return &trackers->trackers[index];
+}
+
+static void
+legacy_feed(struct legacy_trackers *trackers,
+	    const struct device_float_coords *delta,
+	    uint64_t time)
+{
+	struct legacy_tracker *ts = trackers->trackers;
+	unsigned int i, current;
+
+	for (i = 0; i < NTRACKERS; i++) {
+		ts[i].delta.x += delta->x;
+		ts[i].delta.y += delta->y;
+	}
+
+	current = (trackers->cur_tracker + 1) % NTRACKERS;
+	trackers->cur_tracker = current;
+
+	ts[current].delta.x = 0.0;
+	ts[current].delta.y = 0.0;
+	ts[current].time = time;
+	ts[current].dir = device_float_get_direction(*delta);
+}
+
+static inline double
+legacy_tracker_velocity(struct legacy_tracker *tracker, uint64_t time)
+{
+	uint64_t tdelta = time - tracker->time + 1;
+
+	return hypot(tracker->delta.x, tracker->delta.y) / (double)tdelta;
+}
+
+static double
+legacy_velocity(struct legacy_trackers *trackers, uint64_t time)
+{
+	const double MAX_VELOCITY_DIFF = v_ms2us(1);
+	struct legacy_tracker *tracker;
+	double velocity;
+	double result = 0.0;
+	double initial_velocity = 0.0;
+	unsigned int offset;
+	unsigned int dir = legacy_by_offset(trackers, 0)->dir;
+
+	for (offset = 1; offset < NTRACKERS; offset++) {
+		tracker = legacy_by_offset(trackers, offset);
+
+		if (tracker->time > time)
+			break;
+
+		if (time - tracker->time > MOTION_TIMEOUT) {
+			if (offset == 1)
+				result = legacy_tracker_velocity(tracker,
+						tracker->time + MOTION_TIMEOUT);
+			break;
+		}
+
+		velocity = legacy_tracker_velocity(tracker, time);
+
+		dir &= tracker->dir;
+		if (dir == 0) {
+			if (offset == 1)
+				result = velocity;
+			break;
+		}
+
+		if (initial_velocity == 0.0 || offset <= 2) {
+			result = initial_velocity = velocity;
+		} else {
+			if (fabs(initial_velocity - velocity) >
+			    MAX_VELOCITY_DIFF)
+				break;
+			result = velocity;
+		}
+	}
+
+	return result;
+}
+
+static inline uint64_t
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* A mostly straight motion with a change of direction every 200 events,
+ * roughly what a mouse sweep across the screen looks like. */
+static inline struct device_float_coords
+motion_delta(int i)
+{
+	struct device_float_coords delta;
+	int sign = (i / 200) % 2 ? -1 : 1;
+
+	delta.x = sign * (1 + i % 3);
+	delta.y = sign * (i % 5 == 0);
+
+	return delta;
+}
+
+static uint64_t
+bench_legacy(int nevents, uint64_t interval, double *sum)
+{
+	struct legacy_trackers trackers;
+	struct device_float_coords delta;
+	uint64_t time = interval, start;
+	int i;
+
+	memset(&trackers, 0, sizeof(trackers));
+
+	start = now_ns();
+	for (i = 0; i < nevents; i++) {
+		delta = motion_delta(i);
+		legacy_feed(&trackers, &delta, time);
+		*sum += legacy_velocity(&trackers, time);
+		time += interval;
+	}
+
+	return now_ns() - start;
+}
+
+static uint64_t
+bench_trackers(int nevents, uint64_t interval, double *sum,
+	       size_t *ntrackers)
+{
+	struct pointer_trackers trackers;
+	struct device_float_coords delta;
+	uint64_t time = interval, start;
+	int i;
+
+	trackers_init(&trackers);
+
+	start = now_ns();
+	for (i = 0; i < nevents; i++) {
+		delta = motion_delta(i);
+		trackers_feed(&trackers, &delta, time);
+		*sum += trackers_velocity(&trackers, time);
+		time += interval;
+	}
+	start = now_ns() - start;
+
+	*ntrackers = trackers.ntrackers;
+	trackers_free(&trackers);
+
+	return start;
+}
+
+/* A motion at a constant JITTER_SPEED, quantized to whole device units
+ * the way the device reports it. Frames without motion aren't fed, just
+ * like libinput doesn't see them as motion. */
+#define JITTER_SPEED 3.7 /* units/ms */
+
+struct jitter {
+	double pos, last_pos;
+	double sum, sum_sq;
+	int nvelocities;
+};
+
+static inline bool
+jitter_next_delta(struct jitter *jitter,
+		  uint64_t interval,
+		  struct device_float_coords *delta)
+{
+	jitter->pos += JITTER_SPEED * interval / 1000.0;
+	delta->x = floor(jitter->pos) - floor(jitter->last_pos);
+	delta->y = 0;
+	jitter->last_pos = jitter->pos;
+
+	return delta->x != 0.0;
+}
+
+static inline void
+jitter_add_velocity(struct jitter *jitter, double velocity)
+{
+	jitter->sum += velocity;
+	jitter->sum_sq += velocity * velocity;
+	jitter->nvelocities++;
+}
+
+/* Standard deviation of the velocity relative to the mean */
+static double
+jitter_result(const struct jitter *jitter)
+{
+	double mean = jitter->sum / jitter->nvelocities;
+	double variance = jitter->sum_sq / jitter->nvelocities - mean * mean;
+
+	return sqrt(max(variance, 0.0)) / mean;
+}
+
+static double
+jitter_legacy(int nevents, uint64_t interval)
+{
+	struct legacy_trackers trackers;
+	struct jitter jitter = {0};
+	struct device_float_coords delta;
+	uint64_t time = 0;
+	int i;
+
+	memset(&trackers, 0, sizeof(trackers));
+
+	for (i = 0; i < nevents; i++) {
+		time += interval;
+		if (!jitter_next_delta(&jitter, interval, &delta))
+			continue;
+
+		legacy_feed(&trackers, &delta, time);
+		/* skip the ramp-up */
+		if (i > nevents/10)
+			jitter_add_velocity(&jitter,
+					    legacy_velocity(&trackers, time));
+	}
+
+	return jitter_result(&jitter);
+}
+
+static double
+jitter_trackers(int nevents, uint64_t interval)
+{
+	struct pointer_trackers trackers;
+	struct jitter jitter = {0};
+	struct device_float_coords delta;
+	uint64_t time = 0;
+	int i;
+
+	trackers_init(&trackers);
+
+	for (i = 0; i < nevents; i++) {
+		time += interval;
+		if (!jitter_next_delta(&jitter, interval, &delta))
+			continue;
+
+		trackers_feed(&trackers, &delta, time);
+		/* skip the ramp-up */
+		if (i > nevents/10)
+			jitter_add_velocity(&jitter,
+					    trackers_velocity(&trackers, time));
+	}
+
+	trackers_free(&trackers);
+
+	return jitter_result(&jitter);
+}
+
+#define CURVE_MAX_X 50.0 /* units/ms */
+#define CURVE_SAMPLES 100000
+
+/* Measures the lookup in a custom curve of npoints points. The curve
+ * rises monotonically, so the interpolated curve must as well. Returns
+ * false if it doesn't. */
+static bool
+bench_curve(size_t npoints,
+	    enum libinput_config_accel_curve_interpolation interpolation)
+{
+	struct motion_filter *filter;
+	double *a, *fa;
+	double velocity, factor, last_factor = 0.0;
+	double sum = 0.0;
+	bool monotonic = true;
+	uint64_t elapsed;
+	size_t i;
+
+	a = zalloc(npoints * sizeof(*a));
+	fa = zalloc(npoints * sizeof(*fa));
+	for (i = 0; i < npoints; i++) {
+		double x = (double)i / (npoints - 1);
+
+		/* a steep rise with a plateau in the middle, the kind of
+		 * shape where a plain cubic spline overshoots */
+		a[i] = CURVE_MAX_X * x;
+		fa[i] = 0.5 + (x < 0.4 ? x * 5 : x < 0.6 ? 2.0 : x * 5 - 1);
+	}
+
+	filter = create_pointer_accelerator_filter_custom_device_speed();
+	filter_set_curve(filter, a, fa, npoints);
+	filter_set_curve_interpolation(filter, interpolation);
+
+	for (i = 0; i < CURVE_SAMPLES; i++) {
+		velocity = v_ms2us(CURVE_MAX_X) * i / CURVE_SAMPLES;
+		factor = custom_accel_profile(filter, NULL, velocity, 0);
+		if (factor < last_factor)
+			monotonic = false;
+		last_factor = factor;
+	}
+
+	elapsed = now_ns();
+	for (i = 0; i < CURVE_SAMPLES; i++) {
+		velocity = v_ms2us(CURVE_MAX_X) * i / CURVE_SAMPLES;
+		sum += custom_accel_profile(filter, NULL, velocity, 0);
+	}
+	elapsed = now_ns() - elapsed;
+
+	printf("%-14s %7zu %12.2f %12s\n",
+	       interpolation == LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR ?
+			"linear" : "monotone-cubic",
+	       npoints,
+	       (double)elapsed / CURVE_SAMPLES,
+	       monotonic ? "yes" : "NO");
+
+	filter_destroy(filter);
+	free(a);
+	free(fa);
+
+	/* keeps the loop from being optimized out */
+	return monotonic && sum > 0.0;
+}
+
+/* Feeds nevents at the given interval, varied by up to 20% the way the
+ * report rate of real devices jitters. Returns the largest ring size
+ * seen. */
+static size_t
+feed_jittered(struct pointer_trackers *trackers,
+	      uint64_t *time,
+	      int nevents,
+	      uint64_t interval)
+{
+	struct device_float_coords delta = { .x = 1.0, .y = 0.0 };
+	uint64_t jitter = interval / 5;
+	size_t max_size = trackers->ntrackers;
+	int i;
+
+	for (i = 0; i < nevents; i++) {
+		*time += interval - jitter + rand() % (2 * jitter + 1);
+		trackers_feed(trackers, &delta, *time);
+		max_size = max(max_size, trackers->ntrackers);
+	}
+
+	return max_size;
+}
+
+static bool
+check_ring_size(int nevents)
+{
+	struct pointer_trackers trackers;
+	uint64_t time = 0;
+	size_t size;
+	bool success = true;
+
+	srand(1);
+	trackers_init(&trackers);
+
+	/* 16 trackers cover the window at exactly 1000Hz, the jitter of a
+	 * 1000Hz device must not grow the ring */
+	size = feed_jittered(&trackers, &time, nevents, 1000);
+	if (size != TRACKERS_MIN) {
+		fprintf(stderr, "Ring grew to %zu at a jittered 1000Hz\n", size);
+		success = false;
+	}
+
+	/* The ring grows at 8kHz and shrinks back once the rate drops */
+	feed_jittered(&trackers, &time, nevents, 125);
+	if (trackers.ntrackers == TRACKERS_MIN) {
+		fprintf(stderr, "Ring didn't grow at a jittered 8kHz\n");
+		success = false;
+	}
+
+	feed_jittered(&trackers, &time, nevents, 1000);
+	if (trackers.ntrackers != TRACKERS_MIN) {
+		fprintf(stderr,
+			"Ring stayed at %zu after dropping back to 1000Hz\n",
+			trackers.ntrackers);
+		success = false;
+	}
+
+	trackers_free(&trackers);
+
+	return success;
+}
+
+enum batch_filter {
+	BATCH_MOUSE,
+	BATCH_MOUSE_LOW_DPI,
+	BATCH_TOUCHPAD,
+	BATCH_FLAT,
+};
+
+static const char *batch_names[] = {
+	[BATCH_MOUSE] = "mouse",
+	[BATCH_MOUSE_LOW_DPI] = "mouse-low-dpi",
+	[BATCH_TOUCHPAD] = "touchpad",
+	[BATCH_FLAT] = "flat",
+};
+
+static struct motion_filter *
+create_batch_filter(enum batch_filter which)
+{
+	struct motion_filter *filter = NULL;
+
+	switch (which) {
+	case BATCH_MOUSE:
+		filter = create_pointer_accelerator_filter_linear(1600);
+		break;
+	case BATCH_MOUSE_LOW_DPI:
+		filter = create_pointer_accelerator_filter_linear_low_dpi(400);
+		break;
+	case BATCH_TOUCHPAD:
+		filter = create_pointer_accelerator_filter_touchpad(1000, 0, 0);
+		break;
+	case BATCH_FLAT:
+		filter = create_pointer_accelerator_filter_flat(1600);
+		break;
+	}
+
+	return filter;
+}
+
+#define BATCH_SIZE 64
+
+/* Runs the same motion through filter_dispatch() and
+ * filter_dispatch_batch() on two instances of the same filter. Returns
+ * false if the results are not identical. */
+static bool
+bench_batch(enum batch_filter which, int nevents, uint64_t interval)
+{
+	struct motion_filter *single_filter = create_batch_filter(which),
+			     *batch_filter = create_batch_filter(which);
+	struct device_float_coords *deltas;
+	struct normalized_coords *single, *batch;
+	uint64_t *times;
+	uint64_t single_ns, batch_ns;
+	bool identical = true;
+	int i;
+
+	deltas = zalloc(nevents * sizeof(*deltas));
+	times = zalloc(nevents * sizeof(*times));
+	single = zalloc(nevents * sizeof(*single));
+	batch = zalloc(nevents * sizeof(*batch));
+
+	for (i = 0; i < nevents; i++) {
+		deltas[i] = motion_delta(i);
+		times[i] = (i + 1) * interval;
+	}
+
+	single_ns = now_ns();
+	for (i = 0; i < nevents; i++)
+		single[i] = filter_dispatch(single_filter,
+					    &deltas[i],
+					    NULL,
+					    times[i]);
+	single_ns = now_ns() - single_ns;
+
+	batch_ns = now_ns();
+	for (i = 0; i < nevents; i += BATCH_SIZE)
+		filter_dispatch_batch(batch_filter,
+				      &deltas[i],
+				      &times[i],
+				      &batch[i],
+				      min(BATCH_SIZE, nevents - i),
+				      NULL);
+	batch_ns = now_ns() - batch_ns;
+
+	for (i = 0; i < nevents; i++) {
+		if (single[i].x != batch[i].x || single[i].y != batch[i].y) {
+			identical = false;
+			break;
+		}
+	}
+
+	printf("%-14s %12.2f %12.2f %10s\n",
+	       batch_names[which],
+	       (double)single_ns / nevents,
+	       (double)batch_ns / nevents,
+	       identical ? "yes" : "NO");
+
+	filter_destroy(single_filter);
+	filter_destroy(batch_filter);
+	free(deltas);
+	free(times);
+	free(single);
+	free(batch);
+
+	return identical;
+}
+
+static void
+usage(void)
+{
+	printf("Usage: %s [options]\n", program_invocation_short_name);
+	printf("\n"
+	       "Measures the per-event cost of the pointer acceleration\n"
+	       "velocity trackers and the jitter of their velocity at input\n"
+	       "rates from 125Hz to 8kHz and compares them to the previous\n"
+	       "implementation. Then measures the lookup in custom\n"
+	       "acceleration curves and the batched filter dispatch. The\n"
+	       "exit status is nonzero if the velocities differ where they\n"
+	       "must match, if the ring isn't sized correctly for a device\n"
+	       "with a jittering report rate, if a monotonic curve isn't\n"
+	       "monotonic after interpolation or if the batched dispatch\n"
+	       "differs from dispatching one event at a time.\n"
+	       "\n"
+	       "Options:\n"
+	       "--events=<int> ... number of motion events per rate (default: 1000000)\n"
+	       "--help         ... show this help\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	const int rates[] = { 125, 1000, 2000, 4000, 8000 }; /* Hz */
+	const size_t curve_sizes[] = { 32, 1024, 4096, 65536 };
+	int nevents = 1000000;
+	unsigned int i;
+	bool success = true;
+
+	enum {
+		OPT_HELP = 1,
+		OPT_EVENTS,
+	};
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{"events", 1, 0, OPT_EVENTS },
+			{0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "",
+				long_options, &option_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		case OPT_EVENTS:
+			if (!safe_atoi(optarg, &nevents) || nevents <= 0) {
+				usage();
+				return 1;
+			}
+			break;
+		default:
+			usage();
+			return 1;
+		}
+	}
+
+	printf("%-8s %13s %13s %8s %5s %14s %14s\n",
+	       "# rate", "legacy ns/ev", "running ns/ev", "speedup", "ring",
+	       "legacy jitter", "running jitter");
+	for (i = 0; i < ARRAY_LENGTH(rates); i++) {
+		uint64_t interval = 1000000 / rates[i]; /* us */
+		double legacy_sum = 0.0, sum = 0.0;
+		uint64_t legacy, running;
+		size_t ntrackers;
+
+		legacy = bench_legacy(nevents, interval, &legacy_sum);
+		running = bench_trackers(nevents, interval, &sum, &ntrackers);
+
+		/* Up to 1000Hz the ring stays at 16 trackers and both
+		 * implementations must produce the same velocities */
+		if (ntrackers == TRACKERS_MIN && legacy_sum != sum) {
+			fprintf(stderr,
+				"Velocity mismatch at %dHz: %g vs %g\n",
+				rates[i], legacy_sum, sum);
+			success = false;
+		}
+
+		/* jitter: relative standard deviation of the velocity for a
+		 * constant speed motion */
+		printf("%5dHz %13.2f %13.2f %7.2fx %5zu %14.4f %14.4f\n",
+		       rates[i],
+		       (double)legacy / nevents,
+		       (double)running / nevents,
+		       running ? (double)legacy / running : 0.0,
+		       ntrackers,
+		       jitter_legacy(nevents, interval),
+		       jitter_trackers(nevents, interval));
+	}
+
+	if (!check_ring_size(nevents))
+		success = false;
+
+	printf("\n%-14s %7s %12s %12s\n",
+	       "# curve", "points", "ns/lookup", "monotonic");
+	for (i = 0; i < ARRAY_LENGTH(curve_sizes); i++) {
+		if (!bench_curve(curve_sizes[i],
+				 LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_LINEAR))
+			success = false;
+		if (!bench_curve(curve_sizes[i],
+				 LIBINPUT_CONFIG_ACCEL_CURVE_INTERPOLATION_MONOTONE_CUBIC))
+			success = false;
+	}
+
+	printf("\n%-14s %12s %12s %10s\n",
+	       "# batch", "single ns/ev", "batch ns/ev", "identical");
+	for (i = 0; i < ARRAY_LENGTH(batch_names); i++) {
+		if (!bench_batch(i, nevents, 1000))
+			success = false;
+	}
+
+	return success ? 0 : 1;
+}
@@ -114,10 +114,9 @@ print_ptraccel_sequence(struct motion_filter *filter,
 			int nevents,
 			double *deltas)
 {
-	struct device_float_coords motion;
-	struct normalized_coords accel;
-	uint64_t time = 0;
-	double *dx;
+	struct device_float_coords *motion;
+	struct normalized_coords *accel;
+	uint64_t *times;
 	int i;
 
 	printf("# gnuplot:\n");
@@ -128,17 +127,26 @@ print_ptraccel_sequence(struct motion_filter *filter,
 	printf("#      \"gnuplot.data\" using 1:3 title \"dx in\"\n");
 	printf("#\n");
 
-	dx = deltas;
+	motion = zalloc(nevents * sizeof(*motion));
+	accel = zalloc(nevents * sizeof(*accel));
+	times = zalloc(nevents * sizeof(*times));
 
-	for (i = 0; i < nevents; i++, dx++) {
-		motion.x = *dx;
-		motion.y = 0;
-		time += us(12500); /* pretend 80Hz data */
+	for (i = 0; i < nevents; i++) {
+		motion[i].x = deltas[i];
+		motion[i].y = 0;
+		times[i] = (i + 1) * us(12500); /* pretend 80Hz data */
+	}
 
-		accel = filter_dispatch(filter, &motion, NULL, time);
+	/* The whole sequence is known upfront, run it through the filter
+	 * in one go */
+	filter_dispatch_batch(filter, motion, times, accel, nevents, NULL);
 
-		printf("%d	%.3f	%.3f\n", i, accel.x, *dx);
-	}
+	for (i = 0; i < nevents; i++)
+		printf("%d	%.3f	%.3f\n", i, accel[i].x, deltas[i]);
+
+	free(motion);
+	free(accel);
+	free(times);
 }
 
 /* mm/s → units/µs */